@@ -1,3 +1,4 @@
+#include "enum_reflection.h"
 #include <boost/type_index.hpp>
 #include <cstdio>
 #include <string>
@@ -183,6 +184,39 @@ void user_toUType()
     printf("reputation = %ld\n", reputation);
 }
 
+// Color's values are 0 ... 2, so it can only hold 0 ... 3: scan no further
+template <> struct enum_reflection::EnumRange<Color>
+{
+    static constexpr int min = 0;
+    static constexpr int max = 3;
+};
+
+// enumerator names without a switch, see enum_reflection.h
+void use_enum_reflection()
+{
+    using enum_reflection::from_string;
+    using enum_reflection::to_string;
+
+    enum class UserInfoFields
+    {
+        name,
+        email,
+        reputation
+    }; // scoped enum
+
+    for (auto field : enum_reflection::values<UserInfoFields>())
+    {
+        std::string_view s = to_string(field);
+        printf("UserInfoFields %d is %.*s\n", toUType(field), static_cast<int>(s.size()), s.data());
+    }
+    static_assert(to_string(EyeColor::green) == "green" && to_string(red) == "red", "names known at compile time");
+    static_assert(*from_string<EyeColor>("brown") == EyeColor::brown && !from_string<Color>("blue"), "and back");
+    static_assert(enum_reflection::count<Color> == 3 && to_string(static_cast<EyeColor>(7)).empty(), "no others");
+
+    auto eyes = from_string<EyeColor>(std::string("blue")); // a runtime string
+    printf("from_string<EyeColor>(\"blue\") %s\n", eyes && *eyes == EyeColor::blue ? "is EyeColor::blue" : "failed");
+}
+
 int main()
 {
     demo_unscope_enum();
@@ -190,5 +224,6 @@ int main()
     underlaying_type();
     advantage_of_unscoped_enum();
     user_toUType();
+    use_enum_reflection();
     return 0;
 }
\ No newline at end of file
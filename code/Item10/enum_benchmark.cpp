@@ -0,0 +1,168 @@
+#include "../Item24/timing.h"
+#include "enum_reflection.h"
+#include <cstddef>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Enum to string and back, for 1024 random values of a 16-enumerator enum:
+// the compile-time tables of enum_reflection.h against a hand-written switch
+// (an if chain for strings, which can't be switched on) and std::map.
+// Timings go through Item24/timing.h: --format=json|csv and --out=<file> work.
+
+enum class Event
+{
+    connect,
+    disconnect,
+    login,
+    logout,
+    read,
+    write,
+    open,
+    close,
+    create,
+    remove,
+    rename,
+    lock,
+    unlock,
+    flush,
+    sync,
+    timeout
+};
+
+std::string_view switchToString(Event e)
+{
+    switch (e)
+    {
+    case Event::connect:
+        return "connect";
+    case Event::disconnect:
+        return "disconnect";
+    case Event::login:
+        return "login";
+    case Event::logout:
+        return "logout";
+    case Event::read:
+        return "read";
+    case Event::write:
+        return "write";
+    case Event::open:
+        return "open";
+    case Event::close:
+        return "close";
+    case Event::create:
+        return "create";
+    case Event::remove:
+        return "remove";
+    case Event::rename:
+        return "rename";
+    case Event::lock:
+        return "lock";
+    case Event::unlock:
+        return "unlock";
+    case Event::flush:
+        return "flush";
+    case Event::sync:
+        return "sync";
+    case Event::timeout:
+        return "timeout";
+    }
+    return {};
+}
+
+// the string side of the switch: compare against every name in turn
+std::optional<Event> ifChainFromString(std::string_view s)
+{
+    for (int i = 0; i < 16; ++i)
+    {
+        if (switchToString(static_cast<Event>(i)) == s)
+        {
+            return static_cast<Event>(i);
+        }
+    }
+    return std::nullopt;
+}
+
+int main(int argc, char *argv[])
+{
+    timing::Report report(argc, argv);
+    static_assert(enum_reflection::count<Event> == 16, "all the enumerators");
+    for (Event e : enum_reflection::values<Event>())
+    {
+        if (enum_reflection::to_string(e) != switchToString(e))
+        {
+            std::fprintf(report.log(), "the names disagree!\n");
+        }
+    }
+
+    std::map<Event, std::string> toName;
+    std::map<std::string, Event, std::less<>> fromName; // finds string_views without making a std::string
+    for (Event e : enum_reflection::values<Event>())
+    {
+        toName.emplace(e, std::string(switchToString(e)));
+        fromName.emplace(std::string(switchToString(e)), e);
+    }
+
+    std::mt19937 rng(42);
+    std::vector<Event> events(1024);
+    std::vector<std::string> names;
+    for (Event &e : events)
+    {
+        e = static_cast<Event>(std::uniform_int_distribution<int>(0, 15)(rng));
+        names.emplace_back(switchToString(e));
+    }
+
+    report.run("to_string, enum_reflection x1024", [&] {
+        std::size_t total = 0;
+        for (Event e : events)
+        {
+            total += enum_reflection::to_string(e).size();
+        }
+        timing::doNotOptimize(total);
+    });
+    report.run("to_string, switch x1024", [&] {
+        std::size_t total = 0;
+        for (Event e : events)
+        {
+            total += switchToString(e).size();
+        }
+        timing::doNotOptimize(total);
+    });
+    report.run("to_string, std::map x1024", [&] {
+        std::size_t total = 0;
+        for (Event e : events)
+        {
+            total += toName.find(e)->second.size();
+        }
+        timing::doNotOptimize(total);
+    });
+    report.run("from_string, enum_reflection x1024", [&] {
+        int total = 0;
+        for (const std::string &s : names)
+        {
+            total += static_cast<int>(*enum_reflection::from_string<Event>(s));
+        }
+        timing::doNotOptimize(total);
+    });
+    report.run("from_string, if chain x1024", [&] {
+        int total = 0;
+        for (const std::string &s : names)
+        {
+            total += static_cast<int>(*ifChainFromString(s));
+        }
+        timing::doNotOptimize(total);
+    });
+    report.run("from_string, std::map x1024", [&] {
+        int total = 0;
+        for (const std::string &s : names)
+        {
+            total += static_cast<int>(fromName.find(std::string_view(s))->second);
+        }
+        timing::doNotOptimize(total);
+    });
+    return 0;
+}
@@ -0,0 +1,177 @@
+#ifndef __ENUM_REFLECTION_H__
+#define __ENUM_REFLECTION_H__
+
+#include <array>
+#include <cstddef>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+// Enumerator names, computed during compilation.
+//
+// The compiler already knows them: inside a template instantiated with a
+// non-type parameter V of enum type, __PRETTY_FUNCTION__ spells out V, as
+// "Color::red" for an enumerator and "(Color)5" for a value that isn't one.
+// Instantiating that template for every value in EnumRange<E> gives the
+// enumerators and their names, and from those two tables are built:
+// • a dense one indexed by value, for to_string: one bounds check and a load;
+// • one sorted by name length, then name, for from_string: a binary search
+// that mostly compares lengths.
+// Both are static constexpr arrays of std::string_view into string literals, so
+// nothing runs at startup and nothing is allocated.
+//
+// The values scanned default to 0 ... 63; specialize EnumRange for enums with
+// other values. For an unscoped enum without a fixed underlying type, keep the
+// range within the values the enum can hold. Works with GCC and Clang.
+
+namespace enum_reflection
+{
+template <typename E> struct EnumRange
+{
+    static constexpr int min = 0;
+    static constexpr int max = 63;
+};
+
+namespace detail
+{
+template <typename E, E V> constexpr std::string_view prettyName() noexcept
+{
+#if defined(__GNUC__) || defined(__clang__)
+    // GCC: "... [with E = Color; E V = Color::red]", Clang: "... [E = Color, V = Color::red]"
+    return __PRETTY_FUNCTION__;
+#else
+    static_assert(sizeof(E) == 0, "enum_reflection needs GCC or Clang");
+    return {};
+#endif
+}
+
+// the enumerator's unqualified name, or "" if V isn't one
+template <typename E, E V> constexpr std::string_view name() noexcept
+{
+    std::string_view s = prettyName<E, V>();
+    std::size_t first = s.rfind("V = ") + 4;
+    std::size_t last = s.find_first_of(";]", first);
+    s = s.substr(first, last - first);
+    if (s.empty() || s[0] == '(') // a cast: no enumerator has this value
+    {
+        return ""; // empty, but data() isn't null, so printf("%.*s") can take it
+    }
+    std::size_t scope = s.rfind("::");
+    return scope == std::string_view::npos ? s : s.substr(scope + 2);
+}
+
+template <typename E, int... I> constexpr auto scan(std::integer_sequence<int, I...>) noexcept
+{
+    return std::array<std::string_view, sizeof...(I)>{name<E, static_cast<E>(EnumRange<E>::min + I)>()...};
+}
+
+template <typename E> struct Entry
+{
+    std::string_view name;
+    E value;
+};
+
+// shorter names first, then alphabetical: most comparisons stop at the lengths
+constexpr bool nameBefore(std::string_view a, std::string_view b) noexcept
+{
+    return a.size() != b.size() ? a.size() < b.size() : a < b;
+}
+
+template <typename E> struct Tables
+{
+    static constexpr int min = EnumRange<E>::min;
+    static constexpr int max = EnumRange<E>::max;
+    static_assert(min <= max, "empty EnumRange");
+
+    // indexed by value - min; "" where there is no enumerator
+    static constexpr std::array<std::string_view, max - min + 1> names =
+        scan<E>(std::make_integer_sequence<int, max - min + 1>{});
+
+    static constexpr std::size_t count = [] {
+        std::size_t n = 0;
+        for (std::string_view s : names)
+        {
+            n += !s.empty();
+        }
+        return n;
+    }();
+
+    static constexpr std::array<E, count> values = [] {
+        std::array<E, count> v{};
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < names.size(); ++i)
+        {
+            if (!names[i].empty())
+            {
+                v[n++] = static_cast<E>(min + static_cast<int>(i));
+            }
+        }
+        return v;
+    }();
+
+    static constexpr std::array<Entry<E>, count> byName = [] {
+        std::array<Entry<E>, count> sorted{};
+        for (std::size_t i = 0; i < count; ++i) // insertion sort
+        {
+            Entry<E> e{names[static_cast<int>(values[i]) - min], values[i]};
+            std::size_t j = i;
+            for (; j > 0 && nameBefore(e.name, sorted[j - 1].name); --j)
+            {
+                sorted[j] = sorted[j - 1];
+            }
+            sorted[j] = e;
+        }
+        return sorted;
+    }();
+};
+} // namespace detail
+
+// the number of enumerators
+template <typename E> constexpr std::size_t count = detail::Tables<E>::count;
+
+// the enumerators in order of value
+template <typename E> constexpr const std::array<E, count<E>> &values() noexcept
+{
+    return detail::Tables<E>::values;
+}
+
+// the enumerator's name, "" for a value that has none
+template <typename E> constexpr std::string_view to_string(E value) noexcept
+{
+    using Tables = detail::Tables<E>;
+    auto v = static_cast<long long>(static_cast<std::underlying_type_t<E>>(value));
+    if (v < Tables::min || v > Tables::max)
+    {
+        return "";
+    }
+    return Tables::names[static_cast<std::size_t>(v - Tables::min)];
+}
+
+// the enumerator with this name, if there is one
+template <typename E> constexpr std::optional<E> from_string(std::string_view name) noexcept
+{
+    const auto &byName = detail::Tables<E>::byName;
+    std::size_t first = 0;
+    std::size_t last = byName.size();
+    while (first < last) // lower_bound, which isn't constexpr before C++20
+    {
+        std::size_t mid = first + (last - first) / 2;
+        if (detail::nameBefore(byName[mid].name, name))
+        {
+            first = mid + 1;
+        }
+        else
+        {
+            last = mid;
+        }
+    }
+    if (first < byName.size() && byName[first].name == name)
+    {
+        return byName[first].value;
+    }
+    return std::nullopt;
+}
+} // namespace enum_reflection
+
+#endif // !__ENUM_REFLECTION_H__
@@ -0,0 +1,214 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <tuple>
+#include <utility>
+#include <variant>
+#include <vector>
+
+// Batch dispatch over an override hierarchy without a virtual call per element.
+// • vector<unique_ptr<Base>> costs a pointer chase and an indirect branch for
+// every element, and the objects are scattered over the heap.
+// • Grouping objects by dynamic type into contiguous per-type arrays lets each
+// loop call the final override directly, so the call can be inlined.
+// • std::variant keeps one contiguous array in the original order; std::visit
+// dispatches through a jump table instead of a vtable.
+
+namespace devirt
+{
+class Base
+{
+  public:
+    virtual ~Base() = default;
+    virtual double doWork(double x) const = 0;
+};
+
+// marking the overrides final is what lets the compiler bind calls through
+// a Derived& statically
+class Derived1 final : public Base
+{
+  public:
+    explicit Derived1(double s = 1.0) : scale(s)
+    {
+    }
+    double doWork(double x) const override
+    {
+        return x * scale;
+    }
+
+  private:
+    double scale;
+};
+
+class Derived2 final : public Base
+{
+  public:
+    explicit Derived2(double o = 1.0) : offset(o)
+    {
+    }
+    double doWork(double x) const override
+    {
+        return x + offset;
+    }
+
+  private:
+    double offset;
+};
+
+class Derived3 final : public Base
+{
+  public:
+    Derived3(double a = 1.0, double b = 0.0) : mul(a), add(b)
+    {
+    }
+    double doWork(double x) const override
+    {
+        return x * mul + add;
+    }
+
+  private:
+    double mul, add;
+};
+
+// one contiguous std::vector per dynamic type
+template <typename... Ts> class TypeBuckets
+{
+  public:
+    template <typename T, typename... Args> T &emplace(Args &&...args)
+    {
+        return std::get<std::vector<T>>(buckets).emplace_back(std::forward<Args>(args)...);
+    }
+
+    template <typename T> void reserve(std::size_t n)
+    {
+        std::get<std::vector<T>>(buckets).reserve(n);
+    }
+
+    std::size_t size() const
+    {
+        return std::apply([](const auto &...v) { return (v.size() + ... + 0); }, buckets);
+    }
+
+    // f is invoked with the concrete type, one tight loop per bucket
+    template <typename F> void forEach(F &&f)
+    {
+        std::apply([&f](auto &...v) { (forEachIn(v, f), ...); }, buckets);
+    }
+    template <typename F> void forEach(F &&f) const
+    {
+        std::apply([&f](const auto &...v) { (forEachIn(v, f), ...); }, buckets);
+    }
+
+  private:
+    template <typename V, typename F> static void forEachIn(V &v, F &f)
+    {
+        for (auto &obj : v)
+        {
+            f(obj);
+        }
+    }
+
+    std::tuple<std::vector<Ts>...> buckets;
+};
+
+using Buckets = TypeBuckets<Derived1, Derived2, Derived3>;
+using Variant = std::variant<Derived1, Derived2, Derived3>;
+
+void test_buckets()
+{
+    Buckets b;
+    b.emplace<Derived1>(2.0);
+    b.emplace<Derived2>(3.0);
+    b.emplace<Derived3>(2.0, 1.0);
+    b.emplace<Derived1>(4.0);
+
+    double sum = 0;
+    b.forEach([&sum](const auto &obj) { sum += obj.doWork(1.0); }); // non-virtual call, obj is a Derived
+    printf("buckets: %zu objects, sum = %f\n", b.size(), sum);      // 2 + 4 + 3 + 4 = 13
+}
+
+template <typename F> double timeLoop(const char *name, std::size_t n, F &&f)
+{
+    constexpr int reps = 5;
+    double result = 0;
+    auto best = std::chrono::nanoseconds::max();
+    for (int r = 0; r < reps; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        result = f();
+        auto end = std::chrono::steady_clock::now();
+        best = std::min(best, std::chrono::duration_cast<std::chrono::nanoseconds>(end - start));
+    }
+    printf("%-28s %6.2f ns/element (result %.1f)\n", name, static_cast<double>(best.count()) / n, result);
+    return result;
+}
+
+void benchmark(std::size_t n)
+{
+    std::mt19937 gen(42);
+    std::uniform_int_distribution<int> pick(0, 2);
+
+    std::vector<std::unique_ptr<Base>> pointers;
+    std::vector<Variant> variants;
+    Buckets buckets;
+    pointers.reserve(n);
+    variants.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        double k = static_cast<double>(i % 7) * 0.125;
+        switch (pick(gen))
+        {
+        case 0:
+            pointers.push_back(std::make_unique<Derived1>(k));
+            variants.emplace_back(Derived1(k));
+            buckets.emplace<Derived1>(k);
+            break;
+        case 1:
+            pointers.push_back(std::make_unique<Derived2>(k));
+            variants.emplace_back(Derived2(k));
+            buckets.emplace<Derived2>(k);
+            break;
+        default:
+            pointers.push_back(std::make_unique<Derived3>(k, k));
+            variants.emplace_back(Derived3(k, k));
+            buckets.emplace<Derived3>(k, k);
+            break;
+        }
+    }
+    // objects created interleaved with other allocations end up scattered in
+    // real programs; shuffling the pointers models that
+    std::shuffle(pointers.begin(), pointers.end(), gen);
+
+    printf("%zu objects, 3 dynamic types\n", n);
+    timeLoop("vector<unique_ptr<Base>>", n, [&] {
+        double sum = 0;
+        for (const auto &p : pointers)
+        {
+            sum += p->doWork(1.0); // pointer chase + indirect call
+        }
+        return sum;
+    });
+    timeLoop("vector<variant> + visit", n, [&] {
+        double sum = 0;
+        for (const auto &v : variants)
+        {
+            sum += std::visit([](const auto &obj) { return obj.doWork(1.0); }, v);
+        }
+        return sum;
+    });
+    timeLoop("TypeBuckets::forEach", n, [&] {
+        double sum = 0;
+        buckets.forEach([&sum](const auto &obj) { sum += obj.doWork(1.0); });
+        return sum;
+    });
+}
+} // namespace devirt
+
+int main()
+{
+    devirt::test_buckets();
+    devirt::benchmark(1000000);
+    return 0;
+}
@@ -1,3 +1,5 @@
+#include "../Item23/instrumented.h"
+#include "widget2.h"
 #include <cstdio>
 #include <memory>
 #include <vector>
@@ -222,37 +224,91 @@ void test()
     auto vals2 = makeWidget().data(); // copy temporary Widget().values to vals2, we better move it
 }
 
-class Widget2
+// Widget2 lives in widget2.h, it is shared with the streaming pipeline in widget_pipeline.cpp
+
+void test2()
+{
+    Widget2 w;
+    auto makeWidget = []() -> Widget2 { return Widget2(); };
+
+    auto vals1 = w.data(); // calls lvalue overload for
+                           // Widget::data, copy-
+                           // constructs vals1
+
+    auto vals2 = makeWidget().data(); // calls rvalue overload for
+                                      // Widget::data, move-
+                                      // constructs vals2
+}
+
+void test3()
+{
+    Widget2 w(Widget2::DataType{1, 2, 3, 4, 5, 6, 7});
+
+    double sum = 0; // lvalue readers that don't copy values
+    for (double v : w.view())
+    {
+        sum += v;
+    }
+    printf("sum of view() = %f\n", sum);
+
+    w.forEachBlock(3, [](DataSpan block) { printf("block of %zu, first = %f\n", block.size(), block[0]); });
+
+    // auto dangling = Widget2().view(); // error! view() of an rvalue is deleted
+}
+
+// Widget and Widget2 again, with a DataType that counts its copies and moves
+namespace counted
+{
+using DataType = instrumented::Instrumented<std::vector<double>>;
+
+class Widget
 {
   public:
-    using DataType = std::vector<double>;
+    DataType &data()
+    {
+        return values;
+    }
 
-    DataType &data() & // for lvalue Widgets, return lvalue
+  private:
+    DataType values = DataType(1000, 1.0);
+};
+
+class Widget2
+{
+  public:
+    DataType &data() &
     {
         return values;
     }
-    DataType data() && // for rvalue Widgets, return rvalue
+    DataType data() &&
     {
         return std::move(values);
     }
 
   private:
-    DataType values;
+    DataType values = DataType(1000, 1.0);
 };
 
-void test2()
+template <typename W> void countData(const char *name)
 {
-    Widget2 w;
-    auto makeWidget = []() -> Widget2 { return Widget2(); };
+    W w;
+    auto makeWidget = []() -> W { return W(); };
+    instrumented::reset<std::vector<double>>();
 
-    auto vals1 = w.data(); // calls lvalue overload for
-                           // Widget::data, copy-
-                           // constructs vals1
+    auto vals1 = w.data();
+    auto vals2 = makeWidget().data();
 
-    auto vals2 = makeWidget().data(); // calls rvalue overload for
-                                      // Widget::data, move-
-                                      // constructs vals2
+    instrumented::Counts c = instrumented::counts<std::vector<double>>();
+    printf("%s: %llu copies, %llu moves\n", name, static_cast<unsigned long long>(c[instrumented::copies]),
+           static_cast<unsigned long long>(c[instrumented::moves]));
+}
+
+void test()
+{
+    countData<Widget>("data()");               // 2 copies
+    countData<Widget2>("data() & / data() &&"); // 1 copy, 1 move
 }
+} // namespace counted
 } // namespace reference_qualifiers_demo
 
 int main()
@@ -263,5 +319,7 @@ int main()
     test_Base3();
     reference_qualifiers_demo::test();
     reference_qualifiers_demo::test2();
+    reference_qualifiers_demo::test3();
+    reference_qualifiers_demo::counted::test();
     return 0;
 }
\ No newline at end of file
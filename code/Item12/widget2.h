@@ -0,0 +1,95 @@
+#ifndef __WIDGET2_H__
+#define __WIDGET2_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace reference_qualifiers_demo
+{
+
+// read-only view over a contiguous run of doubles, a C++17 stand-in for
+// std::span<const double>
+class DataSpan
+{
+  public:
+    constexpr DataSpan(const double *ptr = nullptr, std::size_t len = 0) noexcept : p(ptr), n(len)
+    {
+    }
+    constexpr const double *data() const noexcept
+    {
+        return p;
+    }
+    constexpr std::size_t size() const noexcept
+    {
+        return n;
+    }
+    constexpr bool empty() const noexcept
+    {
+        return n == 0;
+    }
+    constexpr const double *begin() const noexcept
+    {
+        return p;
+    }
+    constexpr const double *end() const noexcept
+    {
+        return p + n;
+    }
+    constexpr const double &operator[](std::size_t i) const noexcept
+    {
+        return p[i];
+    }
+
+  private:
+    const double *p;
+    std::size_t n;
+};
+
+class Widget2
+{
+  public:
+    using DataType = std::vector<double>;
+
+    Widget2() = default;
+    explicit Widget2(DataType vals) noexcept : values(std::move(vals)) // adopt a (possibly recycled) buffer
+    {
+    }
+
+    DataType &data() & // for lvalue Widgets, return lvalue
+    {
+        return values;
+    }
+    DataType data() && // for rvalue Widgets, return rvalue
+    {
+        return std::move(values);
+    }
+
+    // lvalue readers that never copy: a view of the whole buffer, or the buffer
+    // handed to callback in blockSize-element chunks (the last one may be shorter)
+    DataSpan view() const &noexcept
+    {
+        return {values.data(), values.size()};
+    }
+    DataSpan view() const && = delete; // a view into a dying temporary would dangle
+
+    template <typename F> void forEachBlock(std::size_t blockSize, F &&callback) const &
+    {
+        if (blockSize == 0)
+        {
+            blockSize = values.size();
+        }
+        for (std::size_t pos = 0; pos < values.size(); pos += blockSize)
+        {
+            callback(DataSpan(values.data() + pos, std::min(blockSize, values.size() - pos)));
+        }
+    }
+
+  private:
+    DataType values;
+};
+
+} // namespace reference_qualifiers_demo
+
+#endif // !__WIDGET2_H__
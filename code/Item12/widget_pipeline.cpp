@@ -0,0 +1,242 @@
+#include "../Item24/counting_new.h"
+#include "widget2.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Producer/consumer streaming of Widget2 values.
+// • Producers fill a Widget2 and hand it over with moves only, consumers read it
+// through the lvalue view()/forEachBlock() API and give the buffer back with the
+// rvalue data() overload.
+// • Buffers are recycled through a pool and the queue is a preallocated ring, so
+// after start-up the pipeline does not touch the heap at all.
+
+namespace pipeline
+{
+using reference_qualifiers_demo::DataSpan;
+using reference_qualifiers_demo::Widget2;
+using DataType = Widget2::DataType;
+
+// free list of vectors that keep their capacity between uses
+class BufferPool
+{
+  public:
+    BufferPool(std::size_t count, std::size_t elems)
+    {
+        buffers.reserve(count); // never grows past count, so release() never reallocates
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            DataType v;
+            v.reserve(elems);
+            buffers.push_back(std::move(v));
+        }
+    }
+
+    DataType acquire()
+    {
+        std::lock_guard<std::mutex> guard{m};
+        if (buffers.empty())
+        {
+            return DataType{}; // pool too small: fall back to a fresh buffer
+        }
+        DataType v = std::move(buffers.back());
+        buffers.pop_back();
+        return v;
+    }
+
+    void release(DataType v)
+    {
+        v.clear(); // keeps capacity
+        std::lock_guard<std::mutex> guard{m};
+        if (buffers.size() < buffers.capacity())
+        {
+            buffers.push_back(std::move(v));
+        }
+    }
+
+  private:
+    std::mutex m;
+    std::vector<DataType> buffers;
+};
+
+// bounded blocking queue over a fixed ring of slots; elements are moved in and out
+template <typename T> class BoundedQueue
+{
+  public:
+    explicit BoundedQueue(std::size_t capacity) : slots(capacity)
+    {
+    }
+
+    void push(T &&item)
+    {
+        std::unique_lock<std::mutex> lock{m};
+        notFull.wait(lock, [this] { return count < slots.size(); });
+        slots[tail] = std::move(item);
+        tail = (tail + 1) % slots.size();
+        ++count;
+        lock.unlock();
+        notEmpty.notify_one();
+    }
+
+    bool pop(T &item) // false once the queue is closed and drained
+    {
+        std::unique_lock<std::mutex> lock{m};
+        notEmpty.wait(lock, [this] { return count > 0 || closed; });
+        if (count == 0)
+        {
+            return false;
+        }
+        item = std::move(slots[head]);
+        head = (head + 1) % slots.size();
+        --count;
+        lock.unlock();
+        notFull.notify_one();
+        return true;
+    }
+
+    void close()
+    {
+        {
+            std::lock_guard<std::mutex> guard{m};
+            closed = true;
+        }
+        notEmpty.notify_all();
+    }
+
+  private:
+    std::mutex m;
+    std::condition_variable notFull, notEmpty;
+    std::vector<T> slots;
+    std::size_t head = 0, tail = 0, count = 0;
+    bool closed = false;
+};
+
+struct Result
+{
+    double seconds;
+    std::size_t bytes;
+    std::size_t allocations;
+    double checksum;
+};
+
+// recycle == false is the naive version: fresh vectors on the producer side and a
+// copy of the lvalue data() on the consumer side
+Result run(int producers, int consumers, std::size_t messages, std::size_t elems, bool recycle)
+{
+    constexpr std::size_t queueCapacity = 16;
+    constexpr std::size_t blockSize = 1024;
+
+    BoundedQueue<Widget2> queue(queueCapacity);
+    BufferPool pool(queueCapacity + producers + consumers, elems);
+    std::atomic<bool> go{false};
+    std::atomic<int> producersLeft{producers};
+    std::vector<double> sums(consumers, 0.0);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            while (!go)
+            {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = p; i < messages; i += producers)
+            {
+                DataType v = recycle ? pool.acquire() : DataType{};
+                v.resize(elems);
+                for (std::size_t j = 0; j < elems; ++j)
+                {
+                    v[j] = static_cast<double>(i + j);
+                }
+                queue.push(Widget2(std::move(v)));
+            }
+            if (--producersLeft == 0)
+            {
+                queue.close();
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&, c] {
+            while (!go)
+            {
+                std::this_thread::yield();
+            }
+            double sum = 0;
+            Widget2 w;
+            while (queue.pop(w))
+            {
+                if (recycle)
+                {
+                    w.forEachBlock(blockSize, [&sum](DataSpan block) {
+                        for (double v : block)
+                        {
+                            sum += v;
+                        }
+                    });
+                    pool.release(std::move(w).data()); // rvalue overload: buffer goes back, no copy
+                }
+                else
+                {
+                    auto vals = w.data(); // lvalue overload: copy-constructs vals
+                    for (double v : vals)
+                    {
+                        sum += v;
+                    }
+                }
+            }
+            sums[c] = sum;
+        });
+    }
+
+    // threads and their bookkeeping are allocated by now, only the steady state is measured
+    auto allocsBefore = counting_new::allocations.load();
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    auto allocsAfter = counting_new::allocations.load();
+
+    Result r;
+    r.seconds = std::chrono::duration<double>(end - start).count();
+    r.bytes = messages * elems * sizeof(double);
+    r.allocations = allocsAfter - allocsBefore;
+    r.checksum = 0;
+    for (double s : sums)
+    {
+        r.checksum += s;
+    }
+    return r;
+}
+
+void benchmark()
+{
+    constexpr std::size_t messages = 1000;
+    constexpr std::size_t elems = 16 * 1024; // 128 KiB per Widget2
+
+    const int configs[][2] = {{1, 1}, {2, 2}, {4, 4}};
+    for (auto &cfg : configs)
+    {
+        for (bool recycle : {false, true})
+        {
+            Result r = run(cfg[0], cfg[1], messages, elems, recycle);
+            printf("%d producer(s) x %d consumer(s), %-10s: %8.1f MB/s, %5zu allocations, checksum %.0f\n", cfg[0],
+                   cfg[1], recycle ? "move+pool" : "copy", r.bytes / r.seconds / 1e6, r.allocations, r.checksum);
+        }
+    }
+}
+} // namespace pipeline
+
+int main()
+{
+    pipeline::benchmark();
+    return 0;
+}
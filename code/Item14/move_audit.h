@@ -0,0 +1,83 @@
+#ifndef __MOVE_AUDIT_H__
+#define __MOVE_AUDIT_H__
+
+#include <boost/type_index.hpp>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// Which of these types would std::vector copy instead of move when it grows?
+//
+// A translation unit can't enumerate its own types, so the audit takes the
+// list: move_audit::report<Widget, Gadget, ...>() prints the types whose move
+// constructor or move assignment isn't noexcept, and
+//
+//     static_assert(move_audit::allNothrowMovable<Widget, Gadget>, "...");
+//
+// turns the same check into a build failure.
+// • vector reallocation uses std::move_if_noexcept: a copyable type whose move
+// constructor may throw is copied, to keep push_back's strong guarantee.
+// • A move-only type with a throwing move is moved anyway, and push_back is
+// left with the basic guarantee only.
+
+namespace move_audit
+{
+template <typename T>
+constexpr bool nothrowMovable = std::is_nothrow_move_constructible<T>::value &&
+                                std::is_nothrow_move_assignable<T>::value;
+
+template <typename... Ts> constexpr bool allNothrowMovable = (nothrowMovable<Ts> && ...);
+
+// the number of types in the list that std::vector copies on reallocation
+template <typename... Ts>
+constexpr std::size_t copiedOnGrowth =
+    (std::size_t(0) + ... +
+     std::size_t(!std::is_nothrow_move_constructible<Ts>::value && std::is_copy_constructible<Ts>::value));
+
+struct Entry
+{
+    std::string name;
+    bool nothrowMoveConstructible;
+    bool nothrowMoveAssignable;
+    bool copyConstructible;
+    bool copiedOnGrowth; // what std::vector does with it when it reallocates
+};
+
+template <typename T> Entry entry()
+{
+    constexpr bool nothrowMove = std::is_nothrow_move_constructible<T>::value;
+    constexpr bool copyable = std::is_copy_constructible<T>::value;
+    return {boost::typeindex::type_id<T>().pretty_name(), nothrowMove, std::is_nothrow_move_assignable<T>::value,
+            copyable, !nothrowMove && copyable};
+}
+
+// all the types, nothrow or not
+template <typename... Ts> std::vector<Entry> audit()
+{
+    return {entry<Ts>()...};
+}
+
+// the types whose moves may throw; returns how many there are
+template <typename... Ts> std::size_t report(std::FILE *out = stdout)
+{
+    std::size_t offenders = 0;
+    for (const Entry &e : audit<Ts...>())
+    {
+        if (e.nothrowMoveConstructible && e.nothrowMoveAssignable)
+        {
+            continue;
+        }
+        ++offenders;
+        std::fprintf(out, "%s: move constructor %s, move assignment %s; a growing std::vector %s\n", e.name.c_str(),
+                     e.nothrowMoveConstructible ? "noexcept" : "may throw",
+                     e.nothrowMoveAssignable ? "noexcept" : "may throw",
+                     e.copiedOnGrowth ? "copies it" : "moves it anyway, without the strong guarantee");
+    }
+    std::fprintf(out, "%zu of %zu types have moves that may throw\n", offenders, sizeof...(Ts));
+    return offenders;
+}
+} // namespace move_audit
+
+#endif // !__MOVE_AUDIT_H__
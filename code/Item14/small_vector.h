@@ -0,0 +1,404 @@
+#ifndef __SMALL_VECTOR_H__
+#define __SMALL_VECTOR_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// A vector that keeps its first N elements inside the object, and chooses how
+// to move them to a bigger buffer the way Item 14 says std::vector does, plus
+// one more option.
+// • Trivially relocatable types (by default the trivially copyable ones) move
+// with one memcpy; the old copies are simply forgotten, never destroyed. A
+// type can opt in by specializing small_vector_relocatable.
+// • Types whose move constructor is noexcept, or that can't be copied, are
+// moved one by one.
+// • The others, like a copyable ThrowingMoveType, are copied, so that
+// push_back keeps the strong guarantee: if a copy throws, the old buffer is
+// untouched.
+// insert and erase in the middle shift elements with memmove or with move
+// assignment and give the basic guarantee, as std::vector does.
+
+template <typename T> struct small_vector_relocatable : std::is_trivially_copyable<T>
+{
+};
+
+template <typename T, std::size_t N> class small_vector
+{
+    static_assert(N > 0, "use std::vector for no inline storage");
+
+  public:
+    using value_type = T;
+    using size_type = std::size_t;
+    using reference = T &;
+    using const_reference = const T &;
+    using iterator = T *;
+    using const_iterator = const T *;
+
+    // how elements get to a new buffer, see the top of the file
+    static constexpr bool relocateWithMemcpy = small_vector_relocatable<T>::value;
+    static constexpr bool relocateWithMoves =
+        std::is_nothrow_move_constructible<T>::value || !std::is_copy_constructible<T>::value;
+
+    small_vector() noexcept = default;
+
+    small_vector(std::initializer_list<T> init)
+    {
+        reserve(init.size());
+        for (const T &value : init)
+        {
+            emplace_back(value);
+        }
+    }
+
+    small_vector(const small_vector &rhs)
+    {
+        reserve(rhs.size());
+        for (const T &value : rhs)
+        {
+            emplace_back(value);
+        }
+    }
+
+    small_vector(small_vector &&rhs) noexcept(relocateWithMemcpy || std::is_nothrow_move_constructible<T>::value)
+    {
+        takeFrom(rhs);
+    }
+
+    small_vector &operator=(const small_vector &rhs)
+    {
+        if (this != &rhs)
+        {
+            small_vector copy(rhs);
+            *this = std::move(copy);
+        }
+        return *this;
+    }
+
+    small_vector &operator=(small_vector &&rhs) noexcept(relocateWithMemcpy ||
+                                                         std::is_nothrow_move_constructible<T>::value)
+    {
+        if (this != &rhs)
+        {
+            clear();
+            release();
+            takeFrom(rhs);
+        }
+        return *this;
+    }
+
+    ~small_vector()
+    {
+        clear();
+        release();
+    }
+
+    T *data() noexcept
+    {
+        return ptr;
+    }
+    const T *data() const noexcept
+    {
+        return ptr;
+    }
+    size_type size() const noexcept
+    {
+        return count;
+    }
+    size_type capacity() const noexcept
+    {
+        return cap;
+    }
+    bool empty() const noexcept
+    {
+        return count == 0;
+    }
+    // the elements still live inside the object
+    bool isInline() const noexcept
+    {
+        return ptr == inlineData();
+    }
+
+    iterator begin() noexcept
+    {
+        return ptr;
+    }
+    iterator end() noexcept
+    {
+        return ptr + count;
+    }
+    const_iterator begin() const noexcept
+    {
+        return ptr;
+    }
+    const_iterator end() const noexcept
+    {
+        return ptr + count;
+    }
+
+    T &operator[](size_type i) noexcept
+    {
+        return ptr[i];
+    }
+    const T &operator[](size_type i) const noexcept
+    {
+        return ptr[i];
+    }
+    T &front() noexcept
+    {
+        return ptr[0];
+    }
+    T &back() noexcept
+    {
+        return ptr[count - 1];
+    }
+
+    void reserve(size_type n)
+    {
+        if (n > cap)
+        {
+            T *fresh = allocate(n);
+            try
+            {
+                relocate(fresh);
+            }
+            catch (...)
+            {
+                std::allocator<T>().deallocate(fresh, n);
+                throw;
+            }
+            adopt(fresh, n);
+        }
+    }
+
+    template <typename... Args> T &emplace_back(Args &&...args)
+    {
+        if (count < cap)
+        {
+            ::new (static_cast<void *>(ptr + count)) T(std::forward<Args>(args)...);
+            return ptr[count++];
+        }
+        // the new element first: args may refer to an element of the old buffer
+        size_type newCap = grownCapacity(count + 1);
+        T *fresh = allocate(newCap);
+        try
+        {
+            ::new (static_cast<void *>(fresh + count)) T(std::forward<Args>(args)...);
+        }
+        catch (...)
+        {
+            std::allocator<T>().deallocate(fresh, newCap);
+            throw;
+        }
+        try
+        {
+            relocate(fresh);
+        }
+        catch (...)
+        {
+            fresh[count].~T();
+            std::allocator<T>().deallocate(fresh, newCap);
+            throw;
+        }
+        adopt(fresh, newCap);
+        return ptr[count++];
+    }
+
+    void push_back(const T &value)
+    {
+        emplace_back(value);
+    }
+    void push_back(T &&value)
+    {
+        emplace_back(std::move(value));
+    }
+
+    void pop_back() noexcept
+    {
+        ptr[--count].~T();
+    }
+
+    template <typename... Args> iterator emplace(const_iterator pos, Args &&...args)
+    {
+        size_type index = static_cast<size_type>(pos - ptr);
+        if (index == count)
+        {
+            emplace_back(std::forward<Args>(args)...);
+            return ptr + index;
+        }
+        T value(std::forward<Args>(args)...); // args may refer to an element we are about to shift
+        if (count == cap)
+        {
+            reserve(grownCapacity(count + 1));
+        }
+        if constexpr (relocateWithMemcpy)
+        {
+            std::memmove(static_cast<void *>(ptr + index + 1), ptr + index, (count - index) * sizeof(T));
+            ::new (static_cast<void *>(ptr + index)) T(std::move(value));
+            ++count;
+        }
+        else
+        {
+            ::new (static_cast<void *>(ptr + count)) T(std::move(ptr[count - 1]));
+            ++count;
+            std::move_backward(ptr + index, ptr + count - 2, ptr + count - 1);
+            ptr[index] = std::move(value);
+        }
+        return ptr + index;
+    }
+
+    iterator insert(const_iterator pos, const T &value)
+    {
+        return emplace(pos, value);
+    }
+    iterator insert(const_iterator pos, T &&value)
+    {
+        return emplace(pos, std::move(value));
+    }
+
+    iterator erase(const_iterator pos)
+    {
+        return erase(pos, pos + 1);
+    }
+
+    iterator erase(const_iterator first, const_iterator last)
+    {
+        T *from = ptr + (first - ptr);
+        T *to = ptr + (last - ptr);
+        if (from == to)
+        {
+            return from;
+        }
+        size_type removed = static_cast<size_type>(to - from);
+        if constexpr (relocateWithMemcpy)
+        {
+            destroy(from, to);
+            std::memmove(static_cast<void *>(from), to, (ptr + count - to) * sizeof(T));
+        }
+        else
+        {
+            T *newEnd = std::move(to, ptr + count, from);
+            destroy(newEnd, ptr + count);
+        }
+        count -= removed;
+        return from;
+    }
+
+    void clear() noexcept
+    {
+        destroy(ptr, ptr + count);
+        count = 0;
+    }
+
+  private:
+    T *inlineData() noexcept
+    {
+        return std::launder(reinterpret_cast<T *>(inlineStorage));
+    }
+    const T *inlineData() const noexcept
+    {
+        return std::launder(reinterpret_cast<const T *>(inlineStorage));
+    }
+
+    size_type grownCapacity(size_type needed) const noexcept
+    {
+        return std::max(needed, cap * 2);
+    }
+
+    static T *allocate(size_type n)
+    {
+        return std::allocator<T>().allocate(n);
+    }
+
+    static void destroy(T *first, T *last) noexcept
+    {
+        if constexpr (!std::is_trivially_destructible<T>::value)
+        {
+            for (; first != last; ++first)
+            {
+                first->~T();
+            }
+        }
+    }
+
+    // moves n elements into uninitialized memory, by memcpy if allowed; the
+    // sources are left to the caller
+    static void moveInto(T *from, size_type n, T *to)
+    {
+        if constexpr (relocateWithMemcpy)
+        {
+            if (n > 0)
+            {
+                std::memcpy(static_cast<void *>(to), from, n * sizeof(T));
+            }
+        }
+        else
+        {
+            std::uninitialized_move(from, from + n, to);
+            destroy(from, from + n);
+        }
+    }
+
+    // the current elements into fresh; strong guarantee unless T is
+    // move-only with a throwing move
+    void relocate(T *fresh)
+    {
+        if constexpr (relocateWithMemcpy || relocateWithMoves)
+        {
+            moveInto(ptr, count, fresh);
+        }
+        else
+        {
+            std::uninitialized_copy(ptr, ptr + count, fresh); // cleans up after itself if a copy throws
+            destroy(ptr, ptr + count);
+        }
+    }
+
+    // *this is empty and inline; rhs is left that way
+    void takeFrom(small_vector &rhs)
+    {
+        if (!rhs.isInline())
+        {
+            ptr = rhs.ptr; // steal the buffer
+            count = rhs.count;
+            cap = rhs.cap;
+            rhs.ptr = rhs.inlineData();
+            rhs.count = 0;
+            rhs.cap = N;
+            return;
+        }
+        moveInto(rhs.ptr, rhs.count, ptr);
+        count = rhs.count;
+        rhs.count = 0; // moveInto ended their lifetimes
+    }
+
+    // the elements already live in fresh; forget the old buffer
+    void adopt(T *fresh, size_type newCap) noexcept
+    {
+        release();
+        ptr = fresh;
+        cap = newCap;
+    }
+
+    void release() noexcept
+    {
+        if (!isInline())
+        {
+            std::allocator<T>().deallocate(ptr, cap);
+            ptr = inlineData();
+            cap = N;
+        }
+    }
+
+    alignas(T) unsigned char inlineStorage[N * sizeof(T)];
+    T *ptr = inlineData();
+    size_type count = 0;
+    size_type cap = N;
+};
+
+#endif // !__SMALL_VECTOR_H__
@@ -0,0 +1,140 @@
+#include "../Item24/timing.h"
+#include "small_vector.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// push_back, insert at the front and erase from the front, for std::vector and
+// small_vector, with 8 and 256 elements.
+// • int relocates with memcpy.
+// • std::string relocates with noexcept moves.
+// • MayThrowString, a string whose move constructor isn't noexcept, relocates
+// with copies, exactly as it would in std::vector.
+// small_vector<T, 8> holds the 8-element runs inline and spills the 256-element
+// ones to the heap; small_vector<T, 256> holds both inline.
+// Timings go through Item24/timing.h: --format=json|csv and --out=<file> work.
+
+class MayThrowString
+{
+  public:
+    explicit MayThrowString(std::string s) : s(std::move(s))
+    {
+    }
+    MayThrowString(const MayThrowString &) = default;
+    MayThrowString(MayThrowString &&rhs) noexcept(false) : s(std::move(rhs.s))
+    {
+    }
+    MayThrowString &operator=(const MayThrowString &) = default;
+    MayThrowString &operator=(MayThrowString &&) noexcept(false) = default;
+
+    bool operator==(const MayThrowString &rhs) const
+    {
+        return s == rhs.s;
+    }
+
+  private:
+    std::string s;
+};
+
+static_assert(small_vector<int, 8>::relocateWithMemcpy, "int is trivially relocatable");
+static_assert(!small_vector<std::string, 8>::relocateWithMemcpy && small_vector<std::string, 8>::relocateWithMoves,
+              "std::string moves");
+static_assert(!small_vector<MayThrowString, 8>::relocateWithMoves, "MayThrowString is copied");
+
+template <typename T> T makeValue(int i);
+template <> int makeValue<int>(int i)
+{
+    return i;
+}
+template <> std::string makeValue<std::string>(int i)
+{
+    return std::to_string(i);
+}
+template <> MayThrowString makeValue<MayThrowString>(int i)
+{
+    return MayThrowString(std::to_string(i));
+}
+
+template <typename V> std::size_t pushBack(int n)
+{
+    V v;
+    for (int i = 0; i < n; ++i)
+    {
+        v.push_back(makeValue<typename V::value_type>(i));
+    }
+    return v.size();
+}
+
+template <typename V> V insertFront(int n)
+{
+    V v;
+    for (int i = 0; i < n; ++i)
+    {
+        v.insert(v.begin(), makeValue<typename V::value_type>(i));
+    }
+    return v;
+}
+
+template <typename V> std::size_t eraseFront(int n)
+{
+    V v = insertFront<V>(n);
+    while (!v.empty())
+    {
+        v.erase(v.begin());
+    }
+    return v.size();
+}
+
+// the same elements as std::vector after a mix of all three
+template <typename V> bool agreesWithVector(int n)
+{
+    using T = typename V::value_type;
+    V v = insertFront<V>(n);
+    std::vector<T> expected = insertFront<std::vector<T>>(n);
+    v.erase(v.begin() + 1, v.begin() + n / 2);
+    expected.erase(expected.begin() + 1, expected.begin() + n / 2);
+    v.push_back(makeValue<T>(-1));
+    expected.push_back(makeValue<T>(-1));
+    V copy = v;
+    V moved = std::move(copy);
+    return moved.size() == expected.size() && std::equal(moved.begin(), moved.end(), expected.begin());
+}
+
+template <typename V> void run(timing::Report &report, const std::string &name, int n)
+{
+    if (!agreesWithVector<V>(n))
+    {
+        std::fprintf(report.log(), "%s disagrees with std::vector!\n", name.c_str());
+    }
+    std::string suffix = " " + name + " " + std::to_string(n);
+    report.run("push_back" + suffix, [n] { timing::doNotOptimize(pushBack<V>(n)); });
+    report.run("insert front" + suffix, [n] { timing::doNotOptimize(insertFront<V>(n).size()); });
+    report.run("erase front" + suffix, [n] { timing::doNotOptimize(eraseFront<V>(n)); });
+}
+
+template <typename T> void runAll(timing::Report &report, const char *type)
+{
+    for (int n : {8, 256})
+    {
+        run<std::vector<T>>(report, std::string("vector<") + type + ">", n);
+        run<small_vector<T, 8>>(report, std::string("small_vector<") + type + ", 8>", n);
+        run<small_vector<T, 256>>(report, std::string("small_vector<") + type + ", 256>", n);
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    timing::Options opt;
+    opt.warmup = std::chrono::milliseconds(5);
+    opt.sampleTime = std::chrono::milliseconds(1);
+    opt.samples = 11;
+    timing::Report report(argc, argv, opt);
+
+    runAll<int>(report, "int");
+    runAll<std::string>(report, "string");
+    runAll<MayThrowString>(report, "MayThrowString");
+    report.print();
+    return 0;
+}
@@ -1,3 +1,4 @@
+#include "move_audit.h"
 #include <cstdio>
 #include <stdexcept>
 #include <string>
@@ -178,5 +179,9 @@ int main()
     cpp11::test_swap();
     cpp11::doWork();
     printf("is doWork noexcept: %d\n", noexcept(cpp11::doWork())); // 1
+
+    // which of this file's types would a growing std::vector copy?
+    move_audit::report<cpp98::Widget, cpp11::Widget, cpp11::pair<std::string, std::string>,
+                       cpp11::ThrowingMoveType>();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "../Item23/instrumented.h"
+#include "../Item24/timing.h"
+#include "move_audit.h"
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+// What use_noexcept.cpp says about push_back, measured: a vector that grows
+// copies its elements into the new buffer unless their move constructor is
+// noexcept.
+//
+// Each element type comes in flavors that differ only in the move
+// constructor:
+// • noexcept: reallocation moves.
+// • noexcept(false), copyable: reallocation copies (std::move_if_noexcept).
+// • noexcept(false), move-only, like ThrowingMoveType: reallocation moves and
+// push_back gives only the basic guarantee. (ThrowingMoveType itself always
+// throws, so it can't be put in a vector at all.)
+// The payloads: the std::vector<int> of cpp11::Widget holding 4 ints, the same
+// holding 1024 ints, where a copy costs an allocation and 4 KiB of copying, and
+// a large inline array, where a move costs as much as a copy anyway.
+//
+// emplace_back constructs every element in place, so all the copies and moves
+// counted happen during reallocation. Timings go through Item24/timing.h;
+// --format=json|csv and --out=<file> work here too.
+
+// the flavors
+struct NoexceptMove
+{
+};
+struct MayThrowMove
+{
+};
+struct MayThrowMoveOnly
+{
+};
+
+template <typename Payload, typename Flavor>
+class Element : public instrumented::Counted<Element<Payload, Flavor>> // counts its copies and moves
+{
+    using Base = instrumented::Counted<Element<Payload, Flavor>>;
+    static constexpr bool nothrowMove = std::is_same<Flavor, NoexceptMove>::value;
+
+  public:
+    explicit Element(const Payload &prototype) : payload(prototype)
+    {
+    }
+
+    Element(const Element &rhs) = default;
+    Element(Element &&rhs) noexcept(nothrowMove) : Base(std::move(rhs)), payload(std::move(rhs.payload))
+    {
+    }
+    Element &operator=(const Element &rhs) = default;
+    Element &operator=(Element &&rhs) noexcept(nothrowMove) = default;
+
+  private:
+    Payload payload;
+};
+
+// ThrowingMoveType without the throw: moves declared noexcept(false), no copies
+template <typename Payload> class Element<Payload, MayThrowMoveOnly>
+    : public instrumented::Counted<Element<Payload, MayThrowMoveOnly>>
+{
+    using Base = instrumented::Counted<Element<Payload, MayThrowMoveOnly>>;
+
+  public:
+    explicit Element(const Payload &prototype) : payload(prototype)
+    {
+    }
+
+    Element(const Element &rhs) = delete;
+    Element(Element &&rhs) noexcept(false) : Base(std::move(rhs)), payload(std::move(rhs.payload))
+    {
+    }
+    Element &operator=(const Element &rhs) = delete;
+    Element &operator=(Element &&rhs) noexcept(false) = default;
+
+  private:
+    Payload payload;
+};
+
+using HeapPayload = std::vector<int>; // as in cpp11::Widget; the prototypes hold 4 or 1024 ints
+using InlinePayload = std::array<double, 64>;
+
+constexpr std::size_t elementCount = 4096;
+
+template <typename Payload, typename Flavor> std::size_t grow(const Payload &prototype)
+{
+    std::vector<Element<Payload, Flavor>> v; // no reserve: let it reallocate
+    for (std::size_t i = 0; i < elementCount; ++i)
+    {
+        v.emplace_back(prototype);
+    }
+    return v.size();
+}
+
+template <typename Payload, typename Flavor> void count(std::FILE *out, const char *name, const Payload &prototype)
+{
+    using E = Element<Payload, Flavor>;
+    instrumented::reset<E>();
+    grow<Payload, Flavor>(prototype);
+    instrumented::Counts c = instrumented::counts<E>();
+    std::fprintf(out, "%-40s %10llu %10llu\n", name, static_cast<unsigned long long>(c[instrumented::copies]),
+                 static_cast<unsigned long long>(c[instrumented::moves]));
+}
+
+template <typename Payload>
+void countAndTime(timing::Report &report, const std::string &name, const Payload &prototype)
+{
+    count<Payload, NoexceptMove>(report.log(), (name + ", noexcept").c_str(), prototype);
+    count<Payload, MayThrowMove>(report.log(), (name + ", may throw").c_str(), prototype);
+    count<Payload, MayThrowMoveOnly>(report.log(), (name + ", may throw, move-only").c_str(), prototype);
+
+    report.run(name + ", noexcept", [&] { timing::doNotOptimize(grow<Payload, NoexceptMove>(prototype)); });
+    report.run(name + ", may throw", [&] { timing::doNotOptimize(grow<Payload, MayThrowMove>(prototype)); });
+    report.run(name + ", may throw, move-only",
+               [&] { timing::doNotOptimize(grow<Payload, MayThrowMoveOnly>(prototype)); });
+}
+
+int main(int argc, char *argv[])
+{
+    timing::Options opt;
+    opt.warmup = std::chrono::milliseconds(5);
+    opt.sampleTime = std::chrono::milliseconds(2);
+    opt.samples = 11;
+    timing::Report report(argc, argv, opt);
+
+    move_audit::report<Element<HeapPayload, NoexceptMove>, Element<HeapPayload, MayThrowMove>,
+                       Element<HeapPayload, MayThrowMoveOnly>>(report.log());
+    static_assert(move_audit::copiedOnGrowth<Element<HeapPayload, NoexceptMove>,
+                                             Element<HeapPayload, MayThrowMove>,
+                                             Element<HeapPayload, MayThrowMoveOnly>> == 1,
+                  "only the copyable type with a throwing move is copied on growth");
+    std::fprintf(report.log(), "\n");
+
+    std::fprintf(report.log(), "%zu emplace_backs, no reserve\n", elementCount);
+    std::fprintf(report.log(), "%-40s %10s %10s\n", "element", "copies", "moves");
+    countAndTime(report, "vector<int>(4)", HeapPayload(4, 1));
+    countAndTime(report, "vector<int>(1024)", HeapPayload(1024, 1));
+    countAndTime(report, "array<double, 64>", InlinePayload{});
+    std::fprintf(report.log(), "\n");
+    report.print();
+    return 0;
+}
@@ -0,0 +1,112 @@
+#ifndef __CONSTEXPR_TABLES_H__
+#define __CONSTEXPR_TABLES_H__
+
+#include "pow.h"
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// Lookup tables computed by constexpr functions during compilation.
+//
+// makeTable<N>(f) calls f(0), ..., f(N - 1) and returns the results as a
+// std::array. Stored in a static constexpr member, the array is part of the
+// program image: nothing runs at startup, and a lookup is a single indexed
+// load where the function would have run a loop.
+// • PowTable<Base, Count>: Base to the powers 0 ... Count - 1, by cpp_14::pow.
+// The base is part of the type, so a table only helps when the base is known
+// during compilation and the exponent isn't.
+// • FactorialTable: 0! ... 20!, all the factorials a std::uint64_t can hold.
+// • Crc32Table: the 256 entries of the byte-at-a-time CRC-32 (IEEE 802.3).
+// crc32() uses it and is constexpr too.
+
+namespace tables
+{
+template <std::size_t N, typename F> constexpr auto makeTable(F f)
+{
+    std::array<decltype(f(std::size_t(0))), N> table{};
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        table[i] = f(i);
+    }
+    return table;
+}
+
+template <int Base, std::size_t Count> struct PowTable
+{
+    static constexpr std::array<int, Count> values =
+        makeTable<Count>([](std::size_t exp) { return cpp_14::pow(Base, static_cast<int>(exp)); });
+
+    // exp < Count
+    static constexpr int pow(int exp) noexcept
+    {
+        return values[exp];
+    }
+};
+
+struct FactorialTable
+{
+    static constexpr std::size_t count = 21; // 21! overflows 64 bits
+
+    static constexpr std::array<std::uint64_t, count> values = makeTable<count>([](std::size_t n) {
+        std::uint64_t result = 1;
+        for (std::size_t i = 2; i <= n; ++i)
+        {
+            result *= i;
+        }
+        return result;
+    });
+
+    // n < count
+    static constexpr std::uint64_t factorial(std::size_t n) noexcept
+    {
+        return values[n];
+    }
+};
+
+constexpr std::uint32_t crc32Polynomial = 0xEDB88320; // reflected 0x04C11DB7
+
+// feeds one byte into the CRC, a bit at a time
+constexpr std::uint32_t crc32Step(std::uint32_t crc, unsigned char byte) noexcept
+{
+    crc ^= byte;
+    for (int bit = 0; bit < 8; ++bit)
+    {
+        crc = (crc >> 1) ^ (crc32Polynomial & (0u - (crc & 1)));
+    }
+    return crc;
+}
+
+struct Crc32Table
+{
+    static constexpr std::array<std::uint32_t, 256> values =
+        makeTable<256>([](std::size_t byte) { return crc32Step(0, static_cast<unsigned char>(byte)); });
+};
+
+constexpr std::uint32_t crc32(std::string_view bytes) noexcept
+{
+    std::uint32_t crc = 0xFFFFFFFF;
+    for (char c : bytes)
+    {
+        crc = (crc >> 8) ^ Crc32Table::values[(crc ^ static_cast<unsigned char>(c)) & 0xFF];
+    }
+    return ~crc;
+}
+
+// the same, without the table
+constexpr std::uint32_t crc32Bitwise(std::string_view bytes) noexcept
+{
+    std::uint32_t crc = 0xFFFFFFFF;
+    for (char c : bytes)
+    {
+        crc = crc32Step(crc, static_cast<unsigned char>(c));
+    }
+    return ~crc;
+}
+
+static_assert(PowTable<3, 6>::pow(5) == 243, "3^5");
+static_assert(FactorialTable::factorial(20) == 2432902008176640000ull, "20!");
+static_assert(crc32("123456789") == 0xCBF43926, "the CRC-32 check value");
+} // namespace tables
+
+#endif // !__CONSTEXPR_TABLES_H__
@@ -0,0 +1,81 @@
+#include "../Item24/timing.h"
+#include "pow.h"
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+// cpp_14::pow's multiply loop against ipow, ipowChecked and the batch ipow of
+// pow.h, raising 1024 bases to 1024 exponents.
+// The bases are -2 ... 2 and the exponents stay below 31, so that no result
+// overflows an int: the loop would be undefined behavior otherwise.
+// Timings go through Item24/timing.h: --format=json|csv and --out=<file> work.
+// Build with -O3 to see the batch version vectorized.
+
+int main(int argc, char *argv[])
+{
+    constexpr std::size_t n = 1024;
+    std::mt19937 rng(42);
+    std::vector<int> bases(n);
+    for (int &b : bases)
+    {
+        b = std::uniform_int_distribution<int>(-2, 2)(rng);
+    }
+    std::vector<int> out(n);
+    std::vector<int> expected(n);
+
+    timing::Report report(argc, argv);
+    for (unsigned maxExp : {7u, 15u, 30u})
+    {
+        std::vector<unsigned> exps(n);
+        for (unsigned &e : exps)
+        {
+            e = std::uniform_int_distribution<unsigned>(0, maxExp)(rng);
+        }
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            expected[i] = cpp_14::pow(bases[i], static_cast<int>(exps[i]));
+        }
+        std::string range = ", exp 0.." + std::to_string(maxExp);
+
+        report.run("cpp_14::pow loop" + range, [&] {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = cpp_14::pow(bases[i], static_cast<int>(exps[i]));
+            }
+            timing::doNotOptimize(out.data());
+        });
+        report.run("ipow" + range, [&] {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = cpp_14::ipow(bases[i], exps[i]);
+            }
+            timing::doNotOptimize(out.data());
+        });
+        if (out != expected)
+        {
+            std::fprintf(report.log(), "ipow disagrees with pow!\n");
+        }
+        report.run("ipowChecked" + range, [&] {
+            for (std::size_t i = 0; i < n; ++i)
+            {
+                out[i] = cpp_14::ipowChecked(bases[i], exps[i]).value_or(0);
+            }
+            timing::doNotOptimize(out.data());
+        });
+        if (out != expected)
+        {
+            std::fprintf(report.log(), "ipowChecked disagrees with pow!\n");
+        }
+        report.run("batch ipow" + range, [&] {
+            cpp_14::ipow(bases.data(), exps.data(), out.data(), n);
+            timing::doNotOptimize(out.data());
+        });
+        if (out != expected)
+        {
+            std::fprintf(report.log(), "batch ipow disagrees with pow!\n");
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,50 @@
+#ifndef __POINT_H__
+#define __POINT_H__
+
+// cpp_14::Point of use_constexpr.cpp, shared with the batch kernels in
+// point_batch.h
+
+namespace cpp_14
+{
+class Point
+{
+  public:
+    constexpr Point(double xVal = 0, double yVal = 0) noexcept : x(xVal), y(yVal)
+    {
+    }
+    constexpr double xValue() const noexcept
+    {
+        return x;
+    }
+    constexpr double yValue() const noexcept
+    {
+        return y;
+    }
+    constexpr void setX(double newX) noexcept
+    {
+        x = newX;
+    }
+    constexpr void setY(double newY) noexcept
+    {
+        y = newY;
+    }
+
+  private:
+    double x, y;
+};
+constexpr Point midpoint(const Point &p1, const Point &p2) noexcept
+{
+    return {(p1.xValue() + p2.xValue()) / 2,  // call constexpr
+            (p1.yValue() + p2.yValue()) / 2}; // member funcs
+}
+
+constexpr Point reflection(const Point &p) noexcept
+{
+    Point result;             // create non-const Point
+    result.setX(-p.xValue()); // set its x and y values
+    result.setY(-p.yValue());
+    return result; // return copy of it
+}
+} // namespace cpp_14
+
+#endif // !__POINT_H__
@@ -0,0 +1,264 @@
+#ifndef __POINT_BATCH_H__
+#define __POINT_BATCH_H__
+
+#include "point.h"
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// midpoint, reflection and a translation for whole arrays of points.
+//
+// The points are stored as a structure of arrays (SoA): all the x values, then
+// all the y values, which is what SIMD instructions want. ConstPoints and
+// Points are views of such storage. PointArray<N> owns it in std::arrays and
+// works in constant expressions; PointBuffer owns it in std::vectors.
+// • The kernels in cpp_14::scalar are plain constexpr loops.
+// • The kernels in cpp_14::simd process two points per instruction with
+// GCC/Clang vector extensions, in the 16-byte registers of SSE2 or NEON.
+// • cpp_14::midpoints etc. pick the scalar loops during compilation and the
+// SIMD ones at run time, so the same call precomputes a table in a constexpr
+// PointArray or transforms a million points.
+// Both give the same results as cpp_14::midpoint and cpp_14::reflection: the
+// SIMD versions multiply by 0.5 where those divide by 2, which is exact.
+
+namespace cpp_14
+{
+struct ConstPoints
+{
+    const double *x;
+    const double *y;
+    std::size_t size;
+};
+
+struct Points
+{
+    double *x;
+    double *y;
+    std::size_t size;
+
+    constexpr operator ConstPoints() const noexcept
+    {
+        return {x, y, size};
+    }
+};
+
+template <std::size_t N> struct PointArray
+{
+    std::array<double, N> x{};
+    std::array<double, N> y{};
+
+    constexpr PointArray() noexcept = default;
+    constexpr PointArray(const Point (&points)[N]) noexcept
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            x[i] = points[i].xValue();
+            y[i] = points[i].yValue();
+        }
+    }
+
+    constexpr Point operator[](std::size_t i) const noexcept
+    {
+        return {x[i], y[i]};
+    }
+    constexpr Points view() noexcept
+    {
+        return {x.data(), y.data(), N};
+    }
+    constexpr ConstPoints view() const noexcept
+    {
+        return {x.data(), y.data(), N};
+    }
+};
+
+struct PointBuffer
+{
+    explicit PointBuffer(std::size_t n) : x(n), y(n)
+    {
+    }
+
+    Point operator[](std::size_t i) const noexcept
+    {
+        return {x[i], y[i]};
+    }
+    Points view() noexcept
+    {
+        return {x.data(), y.data(), x.size()};
+    }
+    ConstPoints view() const noexcept
+    {
+        return {x.data(), y.data(), x.size()};
+    }
+
+    std::vector<double> x;
+    std::vector<double> y;
+};
+
+namespace scalar
+{
+// out[i] = midpoint(a[i], b[i])
+constexpr void midpoints(ConstPoints a, ConstPoints b, Points out) noexcept
+{
+    for (std::size_t i = 0; i < out.size; ++i)
+    {
+        out.x[i] = (a.x[i] + b.x[i]) / 2;
+        out.y[i] = (a.y[i] + b.y[i]) / 2;
+    }
+}
+
+// out[i] = reflection(a[i])
+constexpr void reflections(ConstPoints a, Points out) noexcept
+{
+    for (std::size_t i = 0; i < out.size; ++i)
+    {
+        out.x[i] = -a.x[i];
+        out.y[i] = -a.y[i];
+    }
+}
+
+// out[i] = a[i] + (dx, dy)
+constexpr void translations(ConstPoints a, double dx, double dy, Points out) noexcept
+{
+    for (std::size_t i = 0; i < out.size; ++i)
+    {
+        out.x[i] = a.x[i] + dx;
+        out.y[i] = a.y[i] + dy;
+    }
+}
+} // namespace scalar
+
+#if defined(__GNUC__) || defined(__clang__)
+#define POINT_BATCH_SIMD 1
+
+namespace simd
+{
+constexpr std::size_t width = 2; // 16 bytes: one SSE2 or NEON register, always available
+using Vec = double __attribute__((vector_size(width * sizeof(double))));
+
+inline Vec load(const double *p) noexcept
+{
+    Vec v;
+    std::memcpy(&v, p, sizeof(v)); // unaligned load
+    return v;
+}
+
+inline void store(double *p, Vec v) noexcept
+{
+    std::memcpy(p, &v, sizeof(v));
+}
+
+// the whole vectors here, the tail to the scalar loop
+template <typename Kernel, typename Tail> void forEachVector(std::size_t n, Kernel kernel, Tail tail) noexcept
+{
+    std::size_t i = 0;
+    for (; i + width <= n; i += width)
+    {
+        kernel(i);
+    }
+    tail(i);
+}
+
+inline void midpoints(ConstPoints a, ConstPoints b, Points out) noexcept
+{
+    forEachVector(
+        out.size,
+        [&](std::size_t i) {
+            store(out.x + i, (load(a.x + i) + load(b.x + i)) * 0.5);
+            store(out.y + i, (load(a.y + i) + load(b.y + i)) * 0.5);
+        },
+        [&](std::size_t i) {
+            scalar::midpoints({a.x + i, a.y + i, a.size - i}, {b.x + i, b.y + i, b.size - i},
+                              {out.x + i, out.y + i, out.size - i});
+        });
+}
+
+inline void reflections(ConstPoints a, Points out) noexcept
+{
+    forEachVector(
+        out.size,
+        [&](std::size_t i) {
+            store(out.x + i, -load(a.x + i));
+            store(out.y + i, -load(a.y + i));
+        },
+        [&](std::size_t i) {
+            scalar::reflections({a.x + i, a.y + i, a.size - i}, {out.x + i, out.y + i, out.size - i});
+        });
+}
+
+inline void translations(ConstPoints a, double dx, double dy, Points out) noexcept
+{
+    forEachVector(
+        out.size,
+        [&](std::size_t i) {
+            store(out.x + i, load(a.x + i) + dx);
+            store(out.y + i, load(a.y + i) + dy);
+        },
+        [&](std::size_t i) {
+            scalar::translations({a.x + i, a.y + i, a.size - i}, dx, dy, {out.x + i, out.y + i, out.size - i});
+        });
+}
+} // namespace simd
+#endif
+
+// scalar during compilation, SIMD at run time where available
+constexpr void midpoints(ConstPoints a, ConstPoints b, Points out) noexcept
+{
+#ifdef POINT_BATCH_SIMD
+    if (!__builtin_is_constant_evaluated())
+    {
+        simd::midpoints(a, b, out);
+        return;
+    }
+#endif
+    scalar::midpoints(a, b, out);
+}
+
+constexpr void reflections(ConstPoints a, Points out) noexcept
+{
+#ifdef POINT_BATCH_SIMD
+    if (!__builtin_is_constant_evaluated())
+    {
+        simd::reflections(a, out);
+        return;
+    }
+#endif
+    scalar::reflections(a, out);
+}
+
+constexpr void translations(ConstPoints a, double dx, double dy, Points out) noexcept
+{
+#ifdef POINT_BATCH_SIMD
+    if (!__builtin_is_constant_evaluated())
+    {
+        simd::translations(a, dx, dy, out);
+        return;
+    }
+#endif
+    scalar::translations(a, dx, dy, out);
+}
+
+// the PointArray versions, usable to initialize constexpr objects
+template <std::size_t N> constexpr PointArray<N> midpoints(const PointArray<N> &a, const PointArray<N> &b) noexcept
+{
+    PointArray<N> out;
+    midpoints(a.view(), b.view(), out.view());
+    return out;
+}
+
+template <std::size_t N> constexpr PointArray<N> reflections(const PointArray<N> &a) noexcept
+{
+    PointArray<N> out;
+    reflections(a.view(), out.view());
+    return out;
+}
+
+template <std::size_t N> constexpr PointArray<N> translations(const PointArray<N> &a, double dx, double dy) noexcept
+{
+    PointArray<N> out;
+    translations(a.view(), dx, dy, out.view());
+    return out;
+}
+} // namespace cpp_14
+
+#endif // !__POINT_BATCH_H__
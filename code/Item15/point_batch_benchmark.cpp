@@ -0,0 +1,122 @@
+#include "../Item24/timing.h"
+#include "point.h"
+#include "point_batch.h"
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+// Midpoints, reflections and translations of a million points: one
+// cpp_14::Point at a time from a std::vector<Point>, against the SoA kernels of
+// point_batch.h, scalar and SIMD.
+// Timings go through Item24/timing.h: --format=json|csv and --out=<file> work.
+
+using namespace cpp_14;
+
+constexpr std::size_t pointCount = 1 << 20;
+
+bool same(const std::vector<Point> &aos, const PointBuffer &soa)
+{
+    for (std::size_t i = 0; i < aos.size(); ++i)
+    {
+        if (aos[i].xValue() != soa.x[i] || aos[i].yValue() != soa.y[i])
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char *argv[])
+{
+    std::mt19937 rng(42);
+    std::uniform_real_distribution<double> coordinate(-1000, 1000);
+    std::vector<Point> aosA(pointCount), aosB(pointCount), aosOut(pointCount);
+    PointBuffer a(pointCount), b(pointCount), out(pointCount);
+    for (std::size_t i = 0; i < pointCount; ++i)
+    {
+        aosA[i] = Point(coordinate(rng), coordinate(rng));
+        aosB[i] = Point(coordinate(rng), coordinate(rng));
+        a.x[i] = aosA[i].xValue();
+        a.y[i] = aosA[i].yValue();
+        b.x[i] = aosB[i].xValue();
+        b.y[i] = aosB[i].yValue();
+    }
+
+    timing::Options opt;
+    opt.samples = 11;
+    timing::Report report(argc, argv, opt);
+
+    report.run("midpoint, one Point at a time", [&] {
+        for (std::size_t i = 0; i < pointCount; ++i)
+        {
+            aosOut[i] = midpoint(aosA[i], aosB[i]);
+        }
+        timing::doNotOptimize(aosOut.data());
+    });
+    report.run("midpoints, SoA scalar", [&] {
+        scalar::midpoints(a.view(), b.view(), out.view());
+        timing::doNotOptimize(out.x.data());
+    });
+    if (!same(aosOut, out))
+    {
+        std::fprintf(report.log(), "scalar midpoints disagree!\n");
+    }
+    report.run("midpoints, SoA", [&] {
+        midpoints(a.view(), b.view(), out.view());
+        timing::doNotOptimize(out.x.data());
+    });
+    if (!same(aosOut, out))
+    {
+        std::fprintf(report.log(), "midpoints disagree!\n");
+    }
+
+    report.run("reflection, one Point at a time", [&] {
+        for (std::size_t i = 0; i < pointCount; ++i)
+        {
+            aosOut[i] = reflection(aosA[i]);
+        }
+        timing::doNotOptimize(aosOut.data());
+    });
+    report.run("reflections, SoA scalar", [&] {
+        scalar::reflections(a.view(), out.view());
+        timing::doNotOptimize(out.x.data());
+    });
+    if (!same(aosOut, out))
+    {
+        std::fprintf(report.log(), "scalar reflections disagree!\n");
+    }
+    report.run("reflections, SoA", [&] {
+        reflections(a.view(), out.view());
+        timing::doNotOptimize(out.x.data());
+    });
+    if (!same(aosOut, out))
+    {
+        std::fprintf(report.log(), "reflections disagree!\n");
+    }
+
+    report.run("translation, one Point at a time", [&] {
+        for (std::size_t i = 0; i < pointCount; ++i)
+        {
+            aosOut[i] = Point(aosA[i].xValue() + 1.5, aosA[i].yValue() - 2.5);
+        }
+        timing::doNotOptimize(aosOut.data());
+    });
+    report.run("translations, SoA scalar", [&] {
+        scalar::translations(a.view(), 1.5, -2.5, out.view());
+        timing::doNotOptimize(out.x.data());
+    });
+    if (!same(aosOut, out))
+    {
+        std::fprintf(report.log(), "scalar translations disagree!\n");
+    }
+    report.run("translations, SoA", [&] {
+        translations(a.view(), 1.5, -2.5, out.view());
+        timing::doNotOptimize(out.x.data());
+    });
+    if (!same(aosOut, out))
+    {
+        std::fprintf(report.log(), "translations disagree!\n");
+    }
+    return 0;
+}
@@ -0,0 +1,136 @@
+#ifndef __POW_H__
+#define __POW_H__
+
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <type_traits>
+
+// the two pow functions of use_constexpr.cpp, shared with the table generator
+// in constexpr_tables.h, and their faster relatives
+// • ipow squares its way through the bits of exp: O(log exp) multiplies
+// instead of exp. It works in the unsigned type of the same width, so an
+// overflow wraps around, as the loop's does in practice, instead of being
+// undefined behavior. Types narrower than int multiply in unsigned int, since
+// they would otherwise be promoted to int and overflow there.
+// • ipowChecked returns std::nullopt when the result doesn't fit.
+// • The batch ipow raises n bases to n exponents with the same operations for
+// every element, so that the compiler can vectorize it (-O3).
+
+namespace cpp_11
+{
+constexpr int pow(int base, int exp) noexcept // pow's a constexpr func
+{                                             // that never throws
+    return (exp == 0 ? 1 : base * pow(base, exp - 1));
+}
+} // namespace cpp_11
+
+namespace cpp_14
+{
+constexpr int pow(int base, int exp) noexcept
+{
+    auto result = 1;
+    for (int i = 0; i < exp; ++i)
+    {
+        result *= base;
+    }
+    return result;
+}
+
+namespace detail
+{
+// a * b modulo 2^N, for an unsigned U of N bits
+template <typename U> constexpr U mulWrap(U a, U b) noexcept
+{
+    using Wide = std::common_type_t<U, unsigned>; // not int, where U * U would go
+    return static_cast<U>(static_cast<Wide>(a) * static_cast<Wide>(b));
+}
+} // namespace detail
+
+template <typename T> constexpr T ipow(T base, unsigned exp) noexcept
+{
+    static_assert(std::is_integral<T>::value, "integers only");
+    using U = std::make_unsigned_t<T>;
+    U result = 1;
+    U b = static_cast<U>(base);
+    while (exp != 0)
+    {
+        if (exp & 1)
+        {
+            result = detail::mulWrap(result, b);
+        }
+        exp >>= 1;
+        b = detail::mulWrap(b, b);
+    }
+    return static_cast<T>(result);
+}
+
+template <typename T> constexpr std::optional<T> ipowChecked(T base, unsigned exp) noexcept
+{
+    static_assert(std::is_integral<T>::value, "integers only");
+    T result = 1;
+    while (true)
+    {
+        if ((exp & 1) && __builtin_mul_overflow(result, base, &result))
+        {
+            return std::nullopt;
+        }
+        exp >>= 1;
+        if (exp == 0)
+        {
+            return result;
+        }
+        if (__builtin_mul_overflow(base, base, &base)) // a square that is needed later
+        {
+            return std::nullopt;
+        }
+    }
+}
+
+// out[i] = ipow(bases[i], exps[i]); a block at a time, each exponent bit
+// applied to the whole block without branches
+template <typename T> void ipow(const T *bases, const unsigned *exps, T *out, std::size_t n) noexcept
+{
+    static_assert(std::is_integral<T>::value, "integers only");
+    using U = std::make_unsigned_t<T>;
+    constexpr std::size_t block = 64;
+    for (std::size_t first = 0; first < n; first += block)
+    {
+        std::size_t len = n - first < block ? n - first : block;
+        U result[block], b[block];
+        unsigned e[block];
+        unsigned allBits = 0;
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            result[i] = 1;
+            b[i] = static_cast<U>(bases[first + i]);
+            e[i] = exps[first + i];
+            allBits |= e[i];
+        }
+        for (; allBits != 0; allBits >>= 1) // as many rounds as the largest exponent has bits
+        {
+            for (std::size_t i = 0; i < len; ++i)
+            {
+                U factor = static_cast<U>(1 + detail::mulWrap<U>(b[i] - 1, e[i] & 1)); // b[i] or 1
+                result[i] = detail::mulWrap(result[i], factor);
+                b[i] = detail::mulWrap(b[i], b[i]);
+                e[i] >>= 1;
+            }
+        }
+        for (std::size_t i = 0; i < len; ++i)
+        {
+            out[first + i] = static_cast<T>(result[i]);
+        }
+    }
+}
+
+static_assert(ipow(3, 5) == 243 && ipow(-2, 3) == -8 && ipow(10, 0) == 1, "ipow");
+static_assert(ipow<std::uint16_t>(65535, 2) == 1 && ipow<short>(-3, 3) == -27 && ipow<std::int8_t>(2, 8) == 0,
+              "narrower than int: wraps without going through int");
+static_assert(*ipowChecked(10, 9) == 1000000000 && !ipowChecked(10, 10), "int holds 10^9, not 10^10");
+static_assert(*ipowChecked(2, 30) == 1 << 30 && !ipowChecked(2, 31) && *ipowChecked(-2, 31) == INT_MIN,
+              "the edge of int");
+} // namespace cpp_14
+
+#endif // !__POW_H__
@@ -0,0 +1,90 @@
+#include "../Item24/timing.h"
+#include "constexpr_tables.h"
+#include "pow.h"
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// The runtime pow(base, exponent) of use_constexpr_function() against a lookup
+// in a table built during compilation, and the same for factorials and
+// CRC-32. The inputs are generated at run time, so the compiler can't fold
+// the loops away.
+// Timings go through Item24/timing.h: --format=json|csv and --out=<file> work.
+
+std::uint64_t factorialLoop(std::size_t n)
+{
+    std::uint64_t result = 1;
+    for (std::size_t i = 2; i <= n; ++i)
+    {
+        result *= i;
+    }
+    return result;
+}
+
+int main(int argc, char *argv[])
+{
+    std::mt19937 rng(42);
+    std::vector<int> exponents(1024);
+    for (int &e : exponents)
+    {
+        e = std::uniform_int_distribution<int>(0, 9)(rng);
+    }
+    std::vector<std::size_t> factorialArgs(1024);
+    for (std::size_t &n : factorialArgs)
+    {
+        n = std::uniform_int_distribution<std::size_t>(0, tables::FactorialTable::count - 1)(rng);
+    }
+    std::string bytes(4096, '\0');
+    for (char &c : bytes)
+    {
+        c = static_cast<char>(rng());
+    }
+    volatile int runtimeBase = 10; // as if read from the database
+
+    timing::Report report(argc, argv);
+    report.run("cpp_14::pow(base, e) x1024", [&] {
+        int base = runtimeBase;
+        std::int64_t sum = 0; // up to 1024 * 10^9 doesn't fit an int
+        for (int e : exponents)
+        {
+            sum += cpp_14::pow(base, e);
+        }
+        timing::doNotOptimize(sum);
+    });
+    report.run("PowTable<10, 10>::pow(e) x1024", [&] {
+        std::int64_t sum = 0;
+        for (int e : exponents)
+        {
+            sum += tables::PowTable<10, 10>::pow(e);
+        }
+        timing::doNotOptimize(sum);
+    });
+    report.run("factorial loop x1024", [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t n : factorialArgs)
+        {
+            sum += factorialLoop(n);
+        }
+        timing::doNotOptimize(sum);
+    });
+    report.run("FactorialTable x1024", [&] {
+        std::uint64_t sum = 0;
+        for (std::size_t n : factorialArgs)
+        {
+            sum += tables::FactorialTable::factorial(n);
+        }
+        timing::doNotOptimize(sum);
+    });
+    report.run("crc32 bitwise, 4 KiB", [&] { timing::doNotOptimize(tables::crc32Bitwise(bytes)); });
+    report.run("crc32 with table, 4 KiB", [&] { timing::doNotOptimize(tables::crc32(bytes)); });
+
+    if (tables::crc32(bytes) != tables::crc32Bitwise(bytes))
+    {
+        std::fprintf(report.log(), "the CRCs disagree!\n");
+    }
+    return 0;
+}
@@ -1,3 +1,7 @@
+#include "constexpr_tables.h"
+#include "point.h"
+#include "point_batch.h"
+#include "pow.h"
 #include <array>
 #include <boost/type_index.hpp>
 #include <stdio.h>
@@ -28,27 +32,7 @@ void use_constexpr()
            boost::typeindex::type_id_with_cvr<decltype(arraySize2)>().pretty_name().c_str());
 }
 
-namespace cpp_11
-{
-constexpr int pow(int base, int exp) noexcept // pow's a constexpr func
-{                                             // that never throws
-    return (exp == 0 ? 1 : base * pow(base, exp - 1));
-}
-} // namespace cpp_11
-
-namespace cpp_14
-{
-constexpr int pow(int base, int exp) noexcept
-{
-    auto result = 1;
-    for (int i = 0; i < exp; ++i)
-    {
-        result *= base;
-    }
-    return result;
-}
-
-} // namespace cpp_14
+// cpp_11::pow and cpp_14::pow live in pow.h
 
 void use_constexpr_function()
 {
@@ -73,6 +57,21 @@ void use_constexpr_function()
     auto baseToExp = cpp_14::pow(base, exponent); // call pow function
                                                   // at runtime
     printf("baseToExp: %d\n", baseToExp);
+
+    // with the base fixed at compile time, the powers can be too: one load
+    // from a table built during compilation (see constexpr_tables.h)
+    if (base == 10 && exponent < 10)
+    {
+        printf("baseToExp from table: %d\n", tables::PowTable<10, 10>::pow(exponent));
+    }
+
+    // by squaring, and checked: 10^10 doesn't fit in an int (see pow.h)
+    printf("ipow: %d\n", cpp_14::ipow(base, exponent));
+    for (int exp : {exponent, 10})
+    {
+        auto checked = cpp_14::ipowChecked(base, exp);
+        printf("ipowChecked(%d, %d): %s\n", base, exp, checked ? std::to_string(*checked).c_str() : "overflow");
+    }
 }
 
 namespace cpp_11
@@ -110,48 +109,8 @@ constexpr Point midpoint(const Point &p1, const Point &p2) noexcept
 }
 } // namespace cpp_11
 
-namespace cpp_14
-{
-class Point
-{
-  public:
-    constexpr Point(double xVal = 0, double yVal = 0) noexcept : x(xVal), y(yVal)
-    {
-    }
-    constexpr double xValue() const noexcept
-    {
-        return x;
-    }
-    constexpr double yValue() const noexcept
-    {
-        return y;
-    }
-    constexpr void setX(double newX) noexcept
-    {
-        x = newX;
-    }
-    constexpr void setY(double newY) noexcept
-    {
-        y = newY;
-    }
-
-  private:
-    double x, y;
-};
-constexpr Point midpoint(const Point &p1, const Point &p2) noexcept
-{
-    return {(p1.xValue() + p2.xValue()) / 2,  // call constexpr
-            (p1.yValue() + p2.yValue()) / 2}; // member funcs
-}
-
-constexpr Point reflection(const Point &p) noexcept
-{
-    Point result;             // create non-const Point
-    result.setX(-p.xValue()); // set its x and y values
-    result.setY(-p.yValue());
-    return result; // return copy of it
-}
-} // namespace cpp_14
+// cpp_14::Point, midpoint and reflection live in point.h; point_batch.h has
+// versions for whole arrays of points
 
 void use_constexpr_object_cpp_11()
 {
@@ -176,6 +135,18 @@ void use_constexpr_object_cpp_14()
                                           // (-19.1, -16.5) and known
                                           // during compilation
     printf("reflection: (%f, %f)\n", ref.xValue(), ref.yValue());
+
+    // the same for arrays of points, still during compilation (see point_batch.h)
+    constexpr PointArray<3> from({Point(9.4, 27.7), Point(1, 2), Point(-3, 4)});
+    constexpr PointArray<3> to({Point(28.8, 5.3), Point(3, 6), Point(3, -4)});
+    constexpr auto mids = midpoints(from, to);
+    constexpr auto refs = reflections(mids);
+    static_assert(mids[0].xValue() == mid.xValue() && refs[0].yValue() == ref.yValue(), "same as one at a time");
+    for (std::size_t i = 0; i < 3; ++i)
+    {
+        printf("midpoint %zu: (%f, %f), reflected (%f, %f)\n", i, mids[i].xValue(), mids[i].yValue(), refs[i].xValue(),
+               refs[i].yValue());
+    }
 }
 
 int main()
@@ -0,0 +1,143 @@
+#ifndef __INVESTMENT_H__
+#define __INVESTMENT_H__
+
+#include <cstdio>
+
+// set to false to silence the ctor/dtor logging, e.g. in benchmarks
+inline bool traceInvestments = true;
+
+class Investment
+{
+  public:
+    // essential
+    virtual ~Investment()
+    {
+    } // design
+      // component
+
+    virtual double value() const = 0; // current market value of the position
+};
+
+class Stock : public Investment
+{
+  public:
+    explicit Stock(double shares = 0, double price = 0) : numShares(shares), sharePrice(price)
+    {
+        if (traceInvestments)
+        {
+            printf("Stock::Stock()\n");
+        }
+    }
+    ~Stock()
+    {
+        if (traceInvestments)
+        {
+            printf("Stock::~Stock()\n");
+        }
+    }
+
+    double shares() const
+    {
+        return numShares;
+    }
+    double price() const
+    {
+        return sharePrice;
+    }
+    double value() const override
+    {
+        return numShares * sharePrice;
+    }
+
+  private:
+    double numShares, sharePrice;
+};
+
+class Bond : public Investment
+{
+  public:
+    // coupon and yield are annual rates, e.g. 0.05
+    explicit Bond(double faceValue = 0, double coupon = 0, double yield = 0, double years = 0)
+        : face(faceValue), couponRate(coupon), yieldRate(yield), maturity(years)
+    {
+        if (traceInvestments)
+        {
+            printf("Bond::Bond()\n");
+        }
+    }
+    ~Bond()
+    {
+        if (traceInvestments)
+        {
+            printf("Bond::~Bond()\n");
+        }
+    }
+
+    double faceValue() const
+    {
+        return face;
+    }
+    double coupon() const
+    {
+        return couponRate;
+    }
+    double yield() const
+    {
+        return yieldRate;
+    }
+    double years() const
+    {
+        return maturity;
+    }
+    // all coupons plus the face value, discounted with simple interest
+    double value() const override
+    {
+        return face * (1 + couponRate * maturity) / (1 + yieldRate * maturity);
+    }
+
+  private:
+    double face, couponRate, yieldRate, maturity;
+};
+
+class RealEstate : public Investment
+{
+  public:
+    explicit RealEstate(double area = 0, double pricePerSqm = 0, double loan = 0)
+        : sqm(area), sqmPrice(pricePerSqm), mortgage(loan)
+    {
+        if (traceInvestments)
+        {
+            printf("RealEstate::RealEstate()\n");
+        }
+    }
+    ~RealEstate()
+    {
+        if (traceInvestments)
+        {
+            printf("RealEstate::~RealEstate()\n");
+        }
+    }
+
+    double area() const
+    {
+        return sqm;
+    }
+    double pricePerSqm() const
+    {
+        return sqmPrice;
+    }
+    double loan() const
+    {
+        return mortgage;
+    }
+    // equity: market value less the outstanding mortgage
+    double value() const override
+    {
+        return sqm * sqmPrice - mortgage;
+    }
+
+  private:
+    double sqm, sqmPrice, mortgage;
+};
+
+#endif // !__INVESTMENT_H__
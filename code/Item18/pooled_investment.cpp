@@ -0,0 +1,174 @@
+#include "../Item24/churn.h"
+#include "investment.h"
+#include "slab_pool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <utility>
+
+// Pooled allocation for makeInvestment.
+// • Each concrete Investment type gets a slab pool (slab_pool.h): objects are
+// carved out of large slabs and recycled through a per-thread free list, so
+// creation and destruction avoid the general-purpose heap.
+// • The pool is wired in through class-specific operator new/delete on a thin
+// Pooled<T> wrapper. delete on an Investment* runs the virtual destructor, which
+// calls the operator delete of the dynamic type, so the deleter stays stateless
+// and sizeof(unique_ptr) stays one pointer.
+
+namespace pooled
+{
+// T allocated from the slab pool sized for it
+template <typename T> class Pooled final : public T
+{
+  public:
+    using T::T;
+
+    static void *operator new(std::size_t)
+    {
+        static_assert(sizeof(Pooled) == sizeof(T), "Pooled<T> must not add state");
+        return Pool::allocate();
+    }
+
+    static void operator delete(void *p) noexcept
+    {
+        Pool::deallocate(p);
+    }
+
+  private:
+    using Pool = SlabPool<sizeof(T), alignof(T)>;
+};
+
+enum class Kind
+{
+    stock,
+    bond,
+    realEstate
+};
+
+// stateless: delete dispatches through the virtual dtor to Pooled<T>::operator delete.
+// A struct rather than a lambda, because closure types are not assignable before
+// C++20 and a unique_ptr with a lambda deleter can't be move-assigned.
+struct PoolDeleter
+{
+    void operator()(Investment *pInvestment) const noexcept
+    {
+        delete pInvestment;
+    }
+};
+
+using InvestmentPtr = std::unique_ptr<Investment, PoolDeleter>;
+static_assert(sizeof(InvestmentPtr) == sizeof(Investment *), "deleter must not grow unique_ptr");
+
+// same shape as cpp14::makeInvestment in use_unique_ptr.cpp, but the kind is an
+// argument rather than a global flag so that threads can call it concurrently
+template <typename... Ts> InvestmentPtr makeInvestment(Kind kind, Ts &&...params)
+{
+    InvestmentPtr pInv;
+    switch (kind)
+    {
+    case Kind::stock:
+        pInv.reset(new Pooled<Stock>(std::forward<Ts>(params)...));
+        break;
+    case Kind::bond:
+        pInv.reset(new Pooled<Bond>(std::forward<Ts>(params)...));
+        break;
+    case Kind::realEstate:
+        pInv.reset(new Pooled<RealEstate>(std::forward<Ts>(params)...));
+        break;
+    }
+    return pInv;
+}
+} // namespace pooled
+
+namespace heap
+{
+using pooled::Kind;
+
+auto delInvmt = [](Investment *pInvestment) { delete pInvestment; };
+
+template <typename... Ts> std::unique_ptr<Investment, decltype(delInvmt)> makeInvestment(Kind kind, Ts &&...params)
+{
+    std::unique_ptr<Investment, decltype(delInvmt)> pInv(nullptr, delInvmt);
+    switch (kind)
+    {
+    case Kind::stock:
+        pInv.reset(new Stock(std::forward<Ts>(params)...));
+        break;
+    case Kind::bond:
+        pInv.reset(new Bond(std::forward<Ts>(params)...));
+        break;
+    case Kind::realEstate:
+        pInv.reset(new RealEstate(std::forward<Ts>(params)...));
+        break;
+    }
+    return pInv;
+}
+} // namespace heap
+
+void test_pooled_makeInvestment()
+{
+    printf("sizeof(pooled::InvestmentPtr) = %zu\n", sizeof(pooled::InvestmentPtr));
+
+    auto pInv = pooled::makeInvestment(pooled::Kind::stock);
+    auto pInv2 = pooled::makeInvestment(pooled::Kind::bond);
+    auto pInv3 = pooled::makeInvestment(pooled::Kind::realEstate);
+    Investment *first = pInv.get();
+    pInv.reset();
+    pInv = pooled::makeInvestment(pooled::Kind::stock); // reuses the block just freed
+    printf("Stock block reused: %d\n", pInv.get() == first);
+}
+
+// a thread_local constructed before the thread first uses the pool is
+// destroyed after the thread's pool cache, and still frees and allocates
+struct ExitHolder
+{
+    ~ExitHolder()
+    {
+        pInv = pooled::makeInvestment(pooled::Kind::bond);
+    }
+    pooled::InvestmentPtr pInv;
+};
+
+void test_pool_at_thread_exit()
+{
+    std::thread([] {
+        thread_local ExitHolder holder;
+        holder.pInv = pooled::makeInvestment(pooled::Kind::stock);
+    }).join();
+    printf("pool used after the thread's cache was gone\n");
+}
+
+// stock, bond, real estate, stock, ...
+pooled::Kind mixedKind(std::size_t i)
+{
+    const pooled::Kind kinds[] = {pooled::Kind::stock, pooled::Kind::bond, pooled::Kind::realEstate};
+    return kinds[i % 3];
+}
+
+void benchmark()
+{
+    traceInvestments = false;
+    constexpr std::size_t rounds = 20000;
+    unsigned maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        double heapRate =
+            timing::churn(threads, rounds, [](std::size_t i) { return heap::makeInvestment(mixedKind(i)); });
+        double poolRate =
+            timing::churn(threads, rounds, [](std::size_t i) { return pooled::makeInvestment(mixedKind(i)); });
+        printf("%2u thread(s): new/delete %7.2f M create+destroy/s, pooled %7.2f M create+destroy/s\n", threads,
+               heapRate, poolRate);
+    }
+    traceInvestments = true;
+}
+
+int main()
+{
+    test_pooled_makeInvestment();
+    test_pool_at_thread_exit();
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,237 @@
+#include "investment.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <vector>
+
+// Structure-of-arrays storage for investment positions.
+// • A portfolio held as vector<unique_ptr<Investment>> is one heap object per
+// position and one virtual call per valuation.
+// • Portfolio keeps each position type in its own set of columns (one
+// std::vector<double> per field), so a valuation is a straight loop over
+// contiguous doubles with no branches, which the compiler can vectorize.
+
+class Portfolio
+{
+  public:
+    void add(const Stock &s)
+    {
+        stocks.shares.push_back(s.shares());
+        stocks.price.push_back(s.price());
+    }
+    void add(const Bond &b)
+    {
+        bonds.face.push_back(b.faceValue());
+        bonds.coupon.push_back(b.coupon());
+        bonds.yield.push_back(b.yield());
+        bonds.years.push_back(b.years());
+    }
+    void add(const RealEstate &r)
+    {
+        estates.area.push_back(r.area());
+        estates.pricePerSqm.push_back(r.pricePerSqm());
+        estates.loan.push_back(r.loan());
+    }
+
+    // false if inv is none of the known position types
+    bool add(const Investment &inv)
+    {
+        if (auto s = dynamic_cast<const Stock *>(&inv))
+        {
+            add(*s);
+        }
+        else if (auto b = dynamic_cast<const Bond *>(&inv))
+        {
+            add(*b);
+        }
+        else if (auto r = dynamic_cast<const RealEstate *>(&inv))
+        {
+            add(*r);
+        }
+        else
+        {
+            return false;
+        }
+        return true;
+    }
+
+    // conversion from a sequence of makeInvestment results, any deleter type
+    template <typename It> static Portfolio fromInvestments(It first, It last)
+    {
+        Portfolio p;
+        for (; first != last; ++first)
+        {
+            if (*first)
+            {
+                p.add(**first);
+            }
+        }
+        return p;
+    }
+
+    std::size_t size() const
+    {
+        return stocks.shares.size() + bonds.face.size() + estates.area.size();
+    }
+
+    double stockValue() const
+    {
+        return dot(stocks.shares.data(), stocks.price.data(), stocks.shares.size());
+    }
+
+    double bondValue() const
+    {
+        const double *face = bonds.face.data();
+        const double *coupon = bonds.coupon.data();
+        const double *yield = bonds.yield.data();
+        const double *years = bonds.years.data();
+        return reduce(bonds.face.size(), [=](std::size_t i) {
+            return face[i] * (1 + coupon[i] * years[i]) / (1 + yield[i] * years[i]); // same formula as Bond::value
+        });
+    }
+
+    double realEstateValue() const
+    {
+        const double *loan = estates.loan.data();
+        double loans = reduce(estates.loan.size(), [=](std::size_t i) { return loan[i]; });
+        return dot(estates.area.data(), estates.pricePerSqm.data(), estates.area.size()) - loans;
+    }
+
+    double value() const
+    {
+        return stockValue() + bondValue() + realEstateValue();
+    }
+
+  private:
+    // sum of term(i) for i in [0, n). Floating-point addition is not associative,
+    // so a single accumulator pins the order and blocks vectorization unless
+    // -ffast-math is on; four independent partial sums spell out the reordering
+    // and map onto SIMD lanes.
+    template <typename Term> static double reduce(std::size_t n, Term term)
+    {
+        double acc[4] = {0, 0, 0, 0};
+        std::size_t i = 0;
+        for (; i + 4 <= n; i += 4)
+        {
+            acc[0] += term(i);
+            acc[1] += term(i + 1);
+            acc[2] += term(i + 2);
+            acc[3] += term(i + 3);
+        }
+        for (; i < n; ++i)
+        {
+            acc[0] += term(i);
+        }
+        return (acc[0] + acc[1]) + (acc[2] + acc[3]);
+    }
+
+    static double dot(const double *a, const double *b, std::size_t n)
+    {
+        return reduce(n, [=](std::size_t i) { return a[i] * b[i]; });
+    }
+
+    struct StockColumns
+    {
+        std::vector<double> shares, price;
+    } stocks;
+    struct BondColumns
+    {
+        std::vector<double> face, coupon, yield, years;
+    } bonds;
+    struct RealEstateColumns
+    {
+        std::vector<double> area, pricePerSqm, loan;
+    } estates;
+};
+
+// like cpp14::makeInvestment in use_unique_ptr.cpp, with the choice and the
+// constructor arguments passed in
+auto delInvmt = [](Investment *pInvestment) { delete pInvestment; };
+
+using InvestmentPtr = std::unique_ptr<Investment, decltype(delInvmt)>;
+
+InvestmentPtr makeRandomInvestment(std::mt19937 &gen)
+{
+    std::uniform_real_distribution<double> unit(0.0, 1.0);
+    InvestmentPtr pInv(nullptr, delInvmt);
+    switch (gen() % 3)
+    {
+    case 0:
+        pInv.reset(new Stock(1 + 100 * unit(gen), 10 + 90 * unit(gen)));
+        break;
+    case 1:
+        pInv.reset(new Bond(1000, 0.05 * unit(gen), 0.06 * unit(gen), 1 + 29 * unit(gen)));
+        break;
+    default:
+        pInv.reset(new RealEstate(50 + 150 * unit(gen), 2000 + 8000 * unit(gen), 100000 * unit(gen)));
+        break;
+    }
+    return pInv;
+}
+
+void test_portfolio()
+{
+    traceInvestments = false;
+    std::vector<InvestmentPtr> investments;
+    investments.emplace_back(new Stock(10, 25.0), delInvmt);
+    investments.emplace_back(new Bond(1000, 0.05, 0.05, 10), delInvmt);
+    investments.emplace_back(new RealEstate(100, 3000, 200000), delInvmt);
+
+    auto portfolio = Portfolio::fromInvestments(investments.begin(), investments.end());
+    printf("portfolio of %zu positions, value = %.2f\n", portfolio.size(), portfolio.value()); // 250+1000+100000
+    investments.clear();
+    traceInvestments = true;
+}
+
+void benchmark(std::size_t n)
+{
+    traceInvestments = false;
+    std::mt19937 gen(7);
+    std::vector<InvestmentPtr> investments;
+    investments.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        investments.push_back(makeRandomInvestment(gen));
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    auto portfolio = Portfolio::fromInvestments(investments.begin(), investments.end());
+    auto t1 = std::chrono::steady_clock::now();
+    printf("%zu positions, conversion to Portfolio: %.2f ms\n", n,
+           std::chrono::duration<double, std::milli>(t1 - t0).count());
+
+    constexpr int reps = 5;
+    double polymorphic = 0, columnar = 0;
+    auto bestPoly = std::chrono::steady_clock::duration::max();
+    auto bestSoA = std::chrono::steady_clock::duration::max();
+    for (int r = 0; r < reps; ++r)
+    {
+        auto start = std::chrono::steady_clock::now();
+        polymorphic = 0;
+        for (const auto &p : investments)
+        {
+            polymorphic += p->value();
+        }
+        auto mid = std::chrono::steady_clock::now();
+        columnar = portfolio.value();
+        auto end = std::chrono::steady_clock::now();
+        bestPoly = std::min(bestPoly, mid - start);
+        bestSoA = std::min(bestSoA, end - mid);
+    }
+    printf("unique_ptr<Investment> walk: %8.3f ms (value %.6e)\n",
+           std::chrono::duration<double, std::milli>(bestPoly).count(), polymorphic);
+    printf("Portfolio columns:           %8.3f ms (value %.6e)\n",
+           std::chrono::duration<double, std::milli>(bestSoA).count(), columnar);
+    investments.clear();
+    traceInvestments = true;
+}
+
+int main()
+{
+    test_portfolio();
+    benchmark(1000000);
+    return 0;
+}
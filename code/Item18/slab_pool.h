@@ -0,0 +1,189 @@
+#ifndef __SLAB_POOL_H__
+#define __SLAB_POOL_H__
+
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// A fixed-size block allocator with per-thread caches.
+// • Blocks are carved out of large slabs and recycled through a per-thread free
+// list, so allocation and deallocation don't touch the general-purpose heap
+// or take a lock in the common case.
+// • A thread that only frees (e.g. a consumer) hands surplus blocks back to a
+// shared depot instead of hoarding them, and an exiting thread hands back
+// everything it still caches. Blocks allocated or freed later in the thread's
+// exit, by destructors of other thread_locals, go to and from the depot.
+// • The slabs are released when the program ends.
+
+namespace pooled
+{
+// one pool (a set of static members) per block size and alignment
+template <std::size_t Size, std::size_t Align> class SlabPool
+{
+  public:
+    static void *allocate()
+    {
+        if (cacheGone)
+        {
+            Cache one; // hands the rest of the batch back when it goes
+            depot().take(one);
+            return pop(one);
+        }
+        Cache &cache = localCache();
+        if (cache.head == nullptr)
+        {
+            depot().take(cache);
+        }
+        return pop(cache);
+    }
+
+    static void deallocate(void *p) noexcept
+    {
+        FreeNode *node = static_cast<FreeNode *>(p);
+        if (cacheGone)
+        {
+            Cache one;
+            node->next = nullptr;
+            one.head = node;
+            one.count = 1;
+            return; // ~Cache puts the block in the depot
+        }
+        Cache &cache = localCache();
+        node->next = cache.head;
+        cache.head = node;
+        if (++cache.count >= 2 * blocksPerSlab) // give surplus back instead of hoarding it
+        {
+            depot().put(cache, blocksPerSlab);
+        }
+    }
+
+  private:
+    struct FreeNode
+    {
+        FreeNode *next;
+    };
+
+    static constexpr std::size_t align = std::max(Align, alignof(FreeNode));
+    static constexpr std::size_t blockSize = (std::max(Size, sizeof(FreeNode)) + align - 1) / align * align;
+    static constexpr std::size_t blocksPerSlab = 256;
+
+    struct Cache
+    {
+        ~Cache() // thread exit: hand everything back
+        {
+            if (count > 0)
+            {
+                depot().put(*this, count);
+            }
+        }
+
+        FreeNode *head = nullptr;
+        std::size_t count = 0;
+    };
+
+    // owns all slabs; trades batches of free blocks with the thread caches
+    class Depot
+    {
+      public:
+        ~Depot()
+        {
+            for (void *slab : slabs)
+            {
+                ::operator delete(slab, std::align_val_t(align));
+            }
+        }
+
+        // moves the first n blocks of cache into a batch
+        void put(Cache &cache, std::size_t n)
+        {
+            FreeNode *first = cache.head;
+            FreeNode *last = first;
+            for (std::size_t i = 1; i < n; ++i)
+            {
+                last = last->next;
+            }
+            cache.head = last->next;
+            cache.count -= n;
+            last->next = nullptr;
+
+            std::lock_guard<std::mutex> guard{m};
+            batches.push_back({first, n});
+        }
+
+        // refills an empty cache from a returned batch or a new slab
+        void take(Cache &cache)
+        {
+            {
+                std::lock_guard<std::mutex> guard{m};
+                if (!batches.empty())
+                {
+                    cache.head = batches.back().head;
+                    cache.count = batches.back().count;
+                    batches.pop_back();
+                    return;
+                }
+            }
+            char *slab = static_cast<char *>(::operator new(blockSize * blocksPerSlab, std::align_val_t(align)));
+            for (std::size_t i = 0; i + 1 < blocksPerSlab; ++i)
+            {
+                reinterpret_cast<FreeNode *>(slab + i * blockSize)->next =
+                    reinterpret_cast<FreeNode *>(slab + (i + 1) * blockSize);
+            }
+            reinterpret_cast<FreeNode *>(slab + (blocksPerSlab - 1) * blockSize)->next = nullptr;
+
+            {
+                std::lock_guard<std::mutex> guard{m};
+                slabs.push_back(slab);
+            }
+            cache.head = reinterpret_cast<FreeNode *>(slab);
+            cache.count = blocksPerSlab;
+        }
+
+      private:
+        struct Batch
+        {
+            FreeNode *head;
+            std::size_t count;
+        };
+
+        std::mutex m;
+        std::vector<void *> slabs;
+        std::vector<Batch> batches;
+    };
+
+    static FreeNode *pop(Cache &cache) noexcept
+    {
+        FreeNode *node = cache.head;
+        cache.head = node->next;
+        --cache.count;
+        return node;
+    }
+
+    static Depot &depot()
+    {
+        static Depot d;
+        return d;
+    }
+
+    // set once this thread's cache is destroyed; trivially destructible, so
+    // still readable after that
+    static inline thread_local bool cacheGone = false;
+
+    static Cache &localCache()
+    {
+        struct LocalCache : Cache
+        {
+            ~LocalCache()
+            {
+                cacheGone = true;
+            }
+        };
+        thread_local LocalCache cache;
+        return cache;
+    }
+};
+} // namespace pooled
+
+#endif // !__SLAB_POOL_H__
@@ -1,3 +1,4 @@
+#include "investment.h"
 #include <cstdio>
 #include <functional>
 #include <memory>
@@ -11,6 +12,7 @@
 // size of std::unique_ptr objects.
 // • Converting a std::unique_ptr to a std::shared_ptr is easy.
 
+// see ../Item19/smart_ptr_overhead.cpp for what these sizes cost at runtime
 void size_of_unique_ptr()
 {
     printf("sizeof(std::unique_ptr<int>) = %zu\n", sizeof(std::unique_ptr<int>));
@@ -26,54 +28,8 @@ void size_of_unique_ptr()
     printf("sizeof(std::unique_ptr<int, decltype(del)>) = %zu\n", sizeof(std::unique_ptr<int, decltype(del)>)); // same size as *p
 }
 
-class Investment
-{
-  public:
-    // essential
-    virtual ~Investment()
-    {
-    } // design
-      // component
-};
-
-class Stock : public Investment
-{
-  public:
-    Stock()
-    {
-        printf("Stock::Stock()\n");
-    }
-    ~Stock()
-    {
-        printf("Stock::~Stock()\n");
-    }
-};
-
-class Bond : public Investment
-{
-  public:
-    Bond()
-    {
-        printf("Bond::Bond()\n");
-    }
-    ~Bond()
-    {
-        printf("Bond::~Bond()\n");
-    }
-};
-
-class RealEstate : public Investment
-{
-  public:
-    RealEstate()
-    {
-        printf("RealEstate::RealEstate()\n");
-    }
-    ~RealEstate()
-    {
-        printf("RealEstate::~RealEstate()\n");
-    }
-};
+// Investment, Stock, Bond and RealEstate live in investment.h, the pool and
+// portfolio demos share them
 
 bool needStock = true;
 bool needBond = false;
@@ -0,0 +1,294 @@
+#include "mpmc_queue.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Handing std::shared_ptr<Widget2> from producer threads to workers.
+// • Widget2::process() in use_shared_ptr.cpp appends shared_from_this() to a
+// global vector; with several producers that needs a lock and the vector keeps
+// reallocating.
+// • mpmc::BoundedMpmcQueue and mpmc::SegmentedMpmcQueue hand the pointers over
+// without a lock, and consumers take them in batches.
+
+class Widget2 : public std::enable_shared_from_this<Widget2>
+{
+  public:
+    explicit Widget2(long v) : payload(v)
+    {
+    }
+
+    template <typename Sink> void process(Sink &sink)
+    {
+        sink.push(shared_from_this());
+    }
+
+    long payload;
+};
+
+// the baseline: the global vector of use_shared_ptr.cpp, guarded by a mutex
+class LockedVector
+{
+  public:
+    void push(std::shared_ptr<Widget2> &&w)
+    {
+        std::lock_guard<std::mutex> guard{m};
+        items.push_back(std::move(w));
+    }
+
+    template <typename OutIt> std::size_t try_pop_batch(OutIt out, std::size_t maxItems)
+    {
+        std::lock_guard<std::mutex> guard{m};
+        std::size_t n = std::min(maxItems, items.size());
+        std::move(items.end() - n, items.end(), out);
+        items.erase(items.end() - n, items.end());
+        return n;
+    }
+
+  private:
+    std::mutex m;
+    std::vector<std::shared_ptr<Widget2>> items;
+};
+
+class BoundedSink
+{
+  public:
+    explicit BoundedSink(std::size_t capacity) : queue(capacity)
+    {
+    }
+    void push(std::shared_ptr<Widget2> &&w)
+    {
+        while (!queue.try_push(std::move(w))) // full: let a consumer run
+        {
+            std::this_thread::yield();
+        }
+    }
+    template <typename OutIt> std::size_t try_pop_batch(OutIt out, std::size_t maxItems)
+    {
+        return queue.try_pop_batch(out, maxItems);
+    }
+
+  private:
+    mpmc::BoundedMpmcQueue<std::shared_ptr<Widget2>> queue;
+};
+
+class SegmentedSink
+{
+  public:
+    void push(std::shared_ptr<Widget2> &&w)
+    {
+        queue.push(std::move(w));
+    }
+    template <typename OutIt> std::size_t try_pop_batch(OutIt out, std::size_t maxItems)
+    {
+        return queue.try_pop_batch(out, maxItems);
+    }
+
+  private:
+    mpmc::SegmentedMpmcQueue<std::shared_ptr<Widget2>> queue;
+};
+
+void test_queues()
+{
+    mpmc::BoundedMpmcQueue<std::shared_ptr<Widget2>> bounded(4);
+    for (long i = 0; i < 5; ++i)
+    {
+        printf("bounded push %ld: %d\n", i, bounded.try_push(std::make_shared<Widget2>(i))); // the 5th fails
+    }
+    std::vector<std::shared_ptr<Widget2>> out;
+    printf("bounded batch pop: %zu\n", bounded.try_pop_batch(std::back_inserter(out), 8)); // 4
+
+    mpmc::SegmentedMpmcQueue<std::shared_ptr<Widget2>, 4> segmented;
+    for (long i = 0; i < 10; ++i)
+    {
+        segmented.push(std::make_shared<Widget2>(i)); // spans three segments
+    }
+    out.clear();
+    std::size_t n = segmented.try_pop_batch(std::back_inserter(out), 16);
+    printf("segmented batch pop: %zu, first = %ld, last = %ld\n", n, out.front()->payload, out.back()->payload);
+}
+
+// no default constructor
+struct Ticket
+{
+    explicit Ticket(int n) : number(n)
+    {
+    }
+    int number;
+};
+
+void test_not_default_constructible()
+{
+    mpmc::BoundedMpmcQueue<Ticket> bounded(4);
+    mpmc::SegmentedMpmcQueue<Ticket, 4> segmented;
+    for (int i = 0; i < 3; ++i)
+    {
+        bounded.try_push(Ticket(i));
+        segmented.push(Ticket(i));
+    }
+    std::vector<Ticket> out;
+    std::size_t none = bounded.try_pop_batch(std::back_inserter(out), 0);
+    none += segmented.try_pop_batch(std::back_inserter(out), 0);
+    std::size_t n = bounded.try_pop_batch(std::back_inserter(out), 8);
+    n += segmented.try_pop_batch(std::back_inserter(out), 8);
+    printf("Ticket batch pops: %zu with maxItems = 0, then %zu\n", none, n); // 0, then 6
+}
+
+// one queue through thousands of segments, as in a long-running server: the
+// drained ones must be freed while producers and consumers keep going
+void test_segment_reclamation()
+{
+    constexpr int producers = 4;
+    constexpr int consumers = 4;
+    constexpr std::size_t perProducer = 250000;
+    constexpr std::size_t segmentSize = 64;
+    constexpr std::size_t total = producers * perProducer;
+    mpmc::SegmentedMpmcQueue<long, segmentSize> queue;
+    std::atomic<std::size_t> consumed{0};
+    std::atomic<long> checksum{0};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; ++p)
+    {
+        threads.emplace_back([&, p] {
+            for (std::size_t i = p; i < total; i += producers)
+            {
+                queue.push(static_cast<long>(i));
+            }
+        });
+    }
+    for (int c = 0; c < consumers; ++c)
+    {
+        threads.emplace_back([&] {
+            std::vector<long> local;
+            long sum = 0;
+            while (consumed.load(std::memory_order_relaxed) < total)
+            {
+                std::size_t n = queue.try_pop_batch(std::back_inserter(local), 64);
+                for (long v : local)
+                {
+                    sum += v;
+                }
+                local.clear();
+                consumed += n;
+            }
+            checksum += sum;
+        });
+    }
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+
+    // left: the head segment and fewer than 2 * threads + 2 retired ones
+    std::size_t maxLeft = 1 + 2 * (producers + consumers) + 2;
+    printf("%zu items through %zu segments, %zu still allocated\n", total, total / segmentSize, queue.segments());
+    if (queue.segments() > maxLeft)
+    {
+        printf("drained segments were not freed!\n");
+    }
+    if (checksum != static_cast<long>(total * (total - 1) / 2))
+    {
+        printf("checksum mismatch!\n");
+    }
+}
+
+// pairs producers and pairs consumers; returns millions of items per second
+template <typename Sink> double run(Sink &sink, int pairs, const std::vector<std::shared_ptr<Widget2>> &widgets)
+{
+    constexpr std::size_t batch = 64;
+    const std::size_t total = widgets.size();
+    std::atomic<std::size_t> consumed{0};
+    std::atomic<long> checksum{0};
+    std::atomic<bool> go{false};
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < pairs; ++p)
+    {
+        threads.emplace_back([&, p] {
+            while (!go)
+            {
+                std::this_thread::yield();
+            }
+            for (std::size_t i = p; i < total; i += pairs)
+            {
+                widgets[i]->process(sink);
+            }
+        });
+        threads.emplace_back([&] {
+            while (!go)
+            {
+                std::this_thread::yield();
+            }
+            std::vector<std::shared_ptr<Widget2>> local;
+            local.reserve(batch);
+            long sum = 0;
+            while (consumed.load(std::memory_order_relaxed) < total)
+            {
+                std::size_t n = sink.try_pop_batch(std::back_inserter(local), batch);
+                if (n == 0)
+                {
+                    std::this_thread::yield();
+                    continue;
+                }
+                for (const auto &w : local)
+                {
+                    sum += w->payload;
+                }
+                local.clear();
+                consumed += n;
+            }
+            checksum += sum;
+        });
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    go = true;
+    for (auto &t : threads)
+    {
+        t.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    if (checksum != static_cast<long>(total * (total - 1) / 2))
+    {
+        printf("checksum mismatch!\n");
+    }
+    return total / std::chrono::duration<double>(end - start).count() / 1e6;
+}
+
+void benchmark()
+{
+    constexpr std::size_t items = 200000;
+    std::vector<std::shared_ptr<Widget2>> widgets;
+    widgets.reserve(items);
+    for (std::size_t i = 0; i < items; ++i)
+    {
+        widgets.push_back(std::make_shared<Widget2>(static_cast<long>(i)));
+    }
+
+    printf("%8s %16s %16s %16s   (M items/s)\n", "threads", "mutex+vector", "bounded ring", "segmented");
+    for (int pairs = 1; pairs <= 32; pairs *= 2)
+    {
+        LockedVector locked;
+        BoundedSink bounded(1024);
+        SegmentedSink segmented;
+        double a = run(locked, pairs, widgets);
+        double b = run(bounded, pairs, widgets);
+        double c = run(segmented, pairs, widgets);
+        printf("%8d %16.2f %16.2f %16.2f\n", 2 * pairs, a, b, c);
+    }
+}
+
+int main()
+{
+    test_queues();
+    test_not_default_constructible();
+    test_segment_reclamation();
+    benchmark();
+    return 0;
+}
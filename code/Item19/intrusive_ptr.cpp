@@ -0,0 +1,130 @@
+#include "../Item24/counting_new.h"
+#include "intrusive_ptr.h"
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <vector>
+
+// Widget2 from use_shared_ptr.cpp, rebuilt on an intrusive count: create()
+// allocates once instead of twice, and process() recovers an owning pointer
+// from this without enable_shared_from_this's hidden weak_ptr.
+
+namespace with_shared_ptr
+{
+class Widget2 : public std::enable_shared_from_this<Widget2>
+{
+  public:
+    void process(std::vector<std::shared_ptr<Widget2>> &processed)
+    {
+        processed.emplace_back(shared_from_this());
+    }
+
+    template <typename... Ts> static std::shared_ptr<Widget2> create(Ts &&...args)
+    {
+        return std::shared_ptr<Widget2>(new Widget2); // as in use_shared_ptr.cpp
+    }
+
+    long payload = 1;
+
+  private:
+    Widget2() = default;
+};
+} // namespace with_shared_ptr
+
+namespace with_intrusive_ptr
+{
+using intrusive::intrusive_ptr;
+
+class Widget2 : public intrusive::RefCounted<Widget2>
+{
+  public:
+    void process(std::vector<intrusive_ptr<Widget2>> &processed)
+    {
+        processed.emplace_back(ref_from_this());
+    }
+
+    template <typename... Ts> static intrusive_ptr<Widget2> create(Ts &&...args)
+    {
+        return intrusive_ptr<Widget2>(new Widget2(std::forward<Ts>(args)...)); // one allocation
+    }
+
+    long payload = 1;
+
+  private:
+    Widget2() = default;
+};
+} // namespace with_intrusive_ptr
+
+void test_intrusive_ptr()
+{
+    using namespace with_intrusive_ptr;
+
+    printf("sizeof(intrusive_ptr<Widget2>) = %zu\n", sizeof(intrusive_ptr<Widget2>));
+    printf("sizeof(std::shared_ptr<Widget2>) = %zu\n", sizeof(std::shared_ptr<with_shared_ptr::Widget2>));
+
+    std::vector<intrusive_ptr<Widget2>> processed;
+    auto spw = Widget2::create();
+    spw->process(processed);
+    printf("use_count after process = %ld\n", spw.use_count()); // 2
+
+    Widget2 *raw = spw.get();
+    intrusive_ptr<Widget2> again(raw); // safe: the count lives in the object
+    printf("use_count after re-acquiring from raw pointer = %ld\n", again.use_count()); // 3
+}
+
+template <typename MakeFunc> void measure(const char *name, std::size_t n, MakeFunc make)
+{
+    using Ptr = decltype(make());
+    std::vector<Ptr> objects;
+    objects.reserve(n);
+
+    auto allocsBefore = counting_new::allocations.load();
+    auto t0 = std::chrono::steady_clock::now();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        objects.push_back(make());
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    auto allocs = counting_new::allocations.load() - allocsBefore;
+
+    // copy throughput: every copy is one increment now and one decrement later
+    std::vector<Ptr> copies;
+    copies.reserve(n);
+    auto t2 = std::chrono::steady_clock::now();
+    for (const auto &p : objects)
+    {
+        copies.push_back(p);
+    }
+    copies.clear();
+    auto t3 = std::chrono::steady_clock::now();
+
+    // recovering an owning pointer from the object itself
+    using Sink = std::vector<Ptr>;
+    Sink processed;
+    processed.reserve(n);
+    auto t4 = std::chrono::steady_clock::now();
+    for (const auto &p : objects)
+    {
+        p->process(processed);
+    }
+    processed.clear();
+    auto t5 = std::chrono::steady_clock::now();
+
+    auto ns = [n](auto d) { return std::chrono::duration<double, std::nano>(d).count() / n; };
+    printf("%-24s size %2zu B, %.1f allocations/object, create %6.1f ns, copy+release %6.1f ns, from this %6.1f ns\n",
+           name, sizeof(Ptr), static_cast<double>(allocs) / n, ns(t1 - t0), ns(t3 - t2), ns(t5 - t4));
+}
+
+void benchmark()
+{
+    constexpr std::size_t n = 500000;
+    measure("shared_ptr(new Widget2)", n, [] { return with_shared_ptr::Widget2::create(); });
+    measure("intrusive_ptr<Widget2>", n, [] { return with_intrusive_ptr::Widget2::create(); });
+}
+
+int main()
+{
+    test_intrusive_ptr();
+    benchmark();
+    return 0;
+}
@@ -0,0 +1,201 @@
+#ifndef __INTRUSIVE_PTR_H__
+#define __INTRUSIVE_PTR_H__
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Reference counting with the count inside the object.
+//
+// std::shared_ptr keeps its counts in a separate control block, so
+// shared_ptr<T>(new T) costs two allocations and every shared_ptr is two
+// pointers wide. An object deriving from RefCounted<T> carries its own count:
+// intrusive_ptr<T> is a single pointer, make_intrusive allocates once, and an
+// owning pointer can be recovered from a plain T* at any time, which replaces
+// std::enable_shared_from_this.
+
+namespace intrusive
+{
+template <typename T> class intrusive_ptr;
+
+// CRTP base: the count is updated atomically, like std::shared_ptr's, and the
+// last release deletes the object as a Derived, so no virtual destructor is needed
+template <typename Derived> class RefCounted
+{
+  public:
+    long use_count() const noexcept
+    {
+        return refs.load(std::memory_order_relaxed);
+    }
+
+    // the counterpart of shared_from_this(); like it, throws std::bad_weak_ptr
+    // if no intrusive_ptr owns *this yet (e.g. inside the constructor)
+    intrusive_ptr<Derived> ref_from_this();
+    intrusive_ptr<const Derived> ref_from_this() const;
+
+  protected:
+    RefCounted() noexcept = default;
+    RefCounted(const RefCounted &) noexcept // a copy is a new object with its own count
+    {
+    }
+    RefCounted &operator=(const RefCounted &) noexcept
+    {
+        return *this;
+    }
+    ~RefCounted() = default;
+
+  private:
+    friend void intrusive_ptr_add_ref(const RefCounted *p) noexcept
+    {
+        p->refs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    friend void intrusive_ptr_release(const RefCounted *p) noexcept
+    {
+        if (p->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete static_cast<const Derived *>(p);
+        }
+    }
+
+    mutable std::atomic<long> refs{0};
+};
+
+template <typename T> class intrusive_ptr
+{
+  public:
+    using element_type = T;
+
+    constexpr intrusive_ptr() noexcept = default;
+    constexpr intrusive_ptr(std::nullptr_t) noexcept
+    {
+    }
+
+    // adds a reference: taking ownership of a fresh object and re-acquiring one
+    // from a raw pointer are the same operation
+    explicit intrusive_ptr(T *p) noexcept : ptr(p)
+    {
+        if (ptr)
+        {
+            intrusive_ptr_add_ref(ptr);
+        }
+    }
+
+    intrusive_ptr(const intrusive_ptr &r) noexcept : intrusive_ptr(r.ptr)
+    {
+    }
+
+    template <typename Y, typename = std::enable_if_t<std::is_convertible<Y *, T *>::value>>
+    intrusive_ptr(const intrusive_ptr<Y> &r) noexcept : intrusive_ptr(r.get())
+    {
+    }
+
+    intrusive_ptr(intrusive_ptr &&r) noexcept : ptr(r.ptr)
+    {
+        r.ptr = nullptr;
+    }
+
+    template <typename Y, typename = std::enable_if_t<std::is_convertible<Y *, T *>::value>>
+    intrusive_ptr(intrusive_ptr<Y> &&r) noexcept : ptr(r.detach())
+    {
+    }
+
+    ~intrusive_ptr()
+    {
+        if (ptr)
+        {
+            intrusive_ptr_release(ptr);
+        }
+    }
+
+    intrusive_ptr &operator=(const intrusive_ptr &r) noexcept
+    {
+        intrusive_ptr(r).swap(*this);
+        return *this;
+    }
+
+    intrusive_ptr &operator=(intrusive_ptr &&r) noexcept
+    {
+        intrusive_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept
+    {
+        intrusive_ptr().swap(*this);
+    }
+
+    void swap(intrusive_ptr &r) noexcept
+    {
+        std::swap(ptr, r.ptr);
+    }
+
+    // gives up ownership without releasing the reference
+    T *detach() noexcept
+    {
+        T *p = ptr;
+        ptr = nullptr;
+        return p;
+    }
+
+    T *get() const noexcept
+    {
+        return ptr;
+    }
+    T &operator*() const noexcept
+    {
+        return *ptr;
+    }
+    T *operator->() const noexcept
+    {
+        return ptr;
+    }
+    explicit operator bool() const noexcept
+    {
+        return ptr != nullptr;
+    }
+    long use_count() const noexcept
+    {
+        return ptr ? ptr->use_count() : 0;
+    }
+
+  private:
+    T *ptr = nullptr;
+};
+
+template <typename T, typename... Args> intrusive_ptr<T> make_intrusive(Args &&...args)
+{
+    return intrusive_ptr<T>(new T(std::forward<Args>(args)...));
+}
+
+template <typename Derived> intrusive_ptr<Derived> RefCounted<Derived>::ref_from_this()
+{
+    if (use_count() == 0)
+    {
+        throw std::bad_weak_ptr();
+    }
+    return intrusive_ptr<Derived>(static_cast<Derived *>(this));
+}
+
+template <typename Derived> intrusive_ptr<const Derived> RefCounted<Derived>::ref_from_this() const
+{
+    if (use_count() == 0)
+    {
+        throw std::bad_weak_ptr();
+    }
+    return intrusive_ptr<const Derived>(static_cast<const Derived *>(this));
+}
+
+template <typename T, typename U> bool operator==(const intrusive_ptr<T> &a, const intrusive_ptr<U> &b) noexcept
+{
+    return a.get() == b.get();
+}
+template <typename T, typename U> bool operator!=(const intrusive_ptr<T> &a, const intrusive_ptr<U> &b) noexcept
+{
+    return a.get() != b.get();
+}
+} // namespace intrusive
+
+#endif // !__INTRUSIVE_PTR_H__
@@ -0,0 +1,137 @@
+#include "local_shared_ptr.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+// A graph that never leaves its thread pays for atomic reference counting on
+// every std::shared_ptr copy. local::local_shared_ptr has the same interface
+// with plain integer counts; this demo compares the two on a traversal of a
+// DAG that copies a pointer for every edge it follows.
+
+class Widget2 : public local::enable_local_shared_from_this<Widget2>
+{
+  public:
+    void process(std::vector<local::local_shared_ptr<Widget2>> &processed)
+    {
+        processed.emplace_back(shared_from_this());
+    }
+
+    ~Widget2()
+    {
+        printf("Widget2 dtor\n");
+    }
+};
+
+void test_local_shared_ptr()
+{
+    using namespace local;
+
+    auto sp = make_local_shared<int>(42);
+    auto sp2 = sp;
+    printf("*sp = %d, use_count = %ld\n", *sp, sp.use_count()); // 2
+
+    local_weak_ptr<int> wp(sp);
+    sp.reset();
+    sp2.reset();
+    printf("wp expired: %d\n", wp.expired()); // 1
+    printf("wp.lock() is null: %d\n", wp.lock() == nullptr);
+
+    std::vector<local_shared_ptr<Widget2>> processed;
+    auto w = make_local_shared<Widget2>();
+    w->process(processed);
+    printf("use_count after process = %ld\n", w.use_count()); // 2
+
+    local_shared_ptr<int> custom(new int(7), [](int *p) {
+        printf("custom deleter\n");
+        delete p;
+    });
+
+    // in a debug build, touching a count from another thread trips the assertion:
+    // std::thread([&] { auto copy = custom; }).join();
+}
+
+// a DAG with edges only to higher-numbered nodes, so it has no cycles to leak
+template <template <typename> class Ptr> struct Node
+{
+    std::vector<Ptr<Node>> children;
+    long payload = 0;
+};
+
+template <template <typename> class Ptr, typename Make> std::vector<Ptr<Node<Ptr>>> buildGraph(std::size_t n, Make make)
+{
+    std::mt19937 gen(1);
+    std::vector<Ptr<Node<Ptr>>> nodes;
+    nodes.reserve(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        nodes.push_back(make());
+        nodes.back()->payload = static_cast<long>(i);
+    }
+    for (std::size_t i = 0; i + 1 < n; ++i)
+    {
+        for (int k = 0; k < 4; ++k)
+        {
+            std::uniform_int_distribution<std::size_t> pick(i + 1, std::min(n - 1, i + 64));
+            nodes[i]->children.push_back(nodes[pick(gen)]);
+        }
+    }
+    return nodes;
+}
+
+// depth-limited DFS over the DAG: every visit copies all child pointers onto
+// the stack and destroys them again when popped
+template <template <typename> class Ptr> long traverse(const Ptr<Node<Ptr>> &root, int maxDepth)
+{
+    long sum = 0;
+    std::vector<std::pair<Ptr<Node<Ptr>>, int>> stack;
+    stack.emplace_back(root, 0);
+    while (!stack.empty())
+    {
+        auto top = std::move(stack.back());
+        stack.pop_back();
+        sum += top.first->payload;
+        if (top.second < maxDepth)
+        {
+            for (const auto &child : top.first->children)
+            {
+                stack.emplace_back(child, top.second + 1);
+            }
+        }
+    }
+    return sum;
+}
+
+template <typename T> using StdShared = std::shared_ptr<T>;
+template <typename T> using LocalShared = local::local_shared_ptr<T>;
+
+void benchmark()
+{
+    constexpr std::size_t nodes = 10000;
+    constexpr int depth = 10; // 4^0 + ... + 4^10 visits
+    constexpr double visits = ((1 << 22) - 1) / 3;
+
+    auto stdGraph = buildGraph<StdShared>(nodes, [] { return std::make_shared<Node<StdShared>>(); });
+    auto localGraph = buildGraph<LocalShared>(nodes, [] { return local::make_local_shared<Node<LocalShared>>(); });
+
+    auto t0 = std::chrono::steady_clock::now();
+    long a = traverse<StdShared>(stdGraph.front(), depth);
+    auto t1 = std::chrono::steady_clock::now();
+    long b = traverse<LocalShared>(localGraph.front(), depth);
+    auto t2 = std::chrono::steady_clock::now();
+
+    printf("std::shared_ptr traversal:   %6.2f ns/visit (checksum %ld)\n",
+           std::chrono::duration<double, std::nano>(t1 - t0).count() / visits, a);
+    printf("local_shared_ptr traversal:  %6.2f ns/visit (checksum %ld)\n",
+           std::chrono::duration<double, std::nano>(t2 - t1).count() / visits, b);
+}
+
+int main()
+{
+    test_local_shared_ptr();
+    benchmark();
+    return 0;
+}
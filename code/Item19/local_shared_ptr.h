@@ -0,0 +1,466 @@
+#ifndef __LOCAL_SHARED_PTR_H__
+#define __LOCAL_SHARED_PTR_H__
+
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+// Single-threaded counterparts of std::shared_ptr, std::weak_ptr,
+// std::make_shared and std::enable_shared_from_this.
+//
+// std::shared_ptr has to manipulate its reference counts atomically because
+// copies may live on any thread. A local_shared_ptr family is confined to the
+// thread that created it, so its counts are plain integers. Debug builds
+// (NDEBUG not defined) assert that every count change happens on the thread
+// that created the control block.
+
+namespace local
+{
+template <typename T> class local_shared_ptr;
+template <typename T> class local_weak_ptr;
+template <typename T> class enable_local_shared_from_this;
+
+namespace detail
+{
+class ControlBlock
+{
+  public:
+    ControlBlock() = default;
+    ControlBlock(const ControlBlock &) = delete;
+    ControlBlock &operator=(const ControlBlock &) = delete;
+
+    void addRef() noexcept
+    {
+        checkOwner();
+        ++uses;
+    }
+
+    void release() noexcept
+    {
+        checkOwner();
+        if (--uses == 0)
+        {
+            destroyObject();
+            releaseWeak(); // the strong references together hold one weak reference
+        }
+    }
+
+    void addWeak() noexcept
+    {
+        checkOwner();
+        ++weaks;
+    }
+
+    void releaseWeak() noexcept
+    {
+        checkOwner();
+        if (--weaks == 0)
+        {
+            destroySelf();
+        }
+    }
+
+    bool lock() noexcept // add a strong reference unless the object is gone
+    {
+        checkOwner();
+        if (uses == 0)
+        {
+            return false;
+        }
+        ++uses;
+        return true;
+    }
+
+    long useCount() const noexcept
+    {
+        return uses;
+    }
+
+  protected:
+    virtual ~ControlBlock() = default;
+
+  private:
+    virtual void destroyObject() noexcept = 0;
+    virtual void destroySelf() noexcept = 0;
+
+    void checkOwner() const noexcept
+    {
+#ifndef NDEBUG
+        assert(owner == std::this_thread::get_id() && "local_shared_ptr used outside its owning thread");
+#endif
+    }
+
+    long uses = 1;
+    long weaks = 1;
+#ifndef NDEBUG
+    std::thread::id owner = std::this_thread::get_id();
+#endif
+};
+
+// object allocated separately, released through a deleter
+template <typename Y, typename D> class PointerBlock final : public ControlBlock
+{
+  public:
+    PointerBlock(Y *p, D d) : ptr(p), deleter(std::move(d))
+    {
+    }
+
+  private:
+    void destroyObject() noexcept override
+    {
+        deleter(ptr);
+    }
+    void destroySelf() noexcept override
+    {
+        delete this;
+    }
+
+    Y *ptr;
+    D deleter;
+};
+
+// object lives inside the control block, one allocation (make_local_shared)
+template <typename T> class InplaceBlock final : public ControlBlock
+{
+  public:
+    template <typename... Args> explicit InplaceBlock(Args &&...args)
+    {
+        ::new (static_cast<void *>(&storage)) T(std::forward<Args>(args)...);
+    }
+
+    T *get() noexcept
+    {
+        return std::launder(reinterpret_cast<T *>(&storage));
+    }
+
+  private:
+    void destroyObject() noexcept override
+    {
+        get()->~T();
+    }
+    void destroySelf() noexcept override
+    {
+        delete this;
+    }
+
+    typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+};
+} // namespace detail
+
+template <typename T> class local_shared_ptr
+{
+  public:
+    using element_type = T;
+    using weak_type = local_weak_ptr<T>;
+
+    constexpr local_shared_ptr() noexcept = default;
+    constexpr local_shared_ptr(std::nullptr_t) noexcept
+    {
+    }
+
+    template <typename Y> explicit local_shared_ptr(Y *p) : local_shared_ptr(p, std::default_delete<Y>())
+    {
+    }
+
+    template <typename Y, typename D> local_shared_ptr(Y *p, D d) : ptr(p)
+    {
+        try
+        {
+            cb = new detail::PointerBlock<Y, D>(p, d);
+        }
+        catch (...)
+        {
+            d(p); // like std::shared_ptr: the deleter runs if the control block can't be made
+            throw;
+        }
+        enableSharedFromThis(p, p);
+    }
+
+    // aliasing constructor: shares ownership with r, points at p
+    template <typename Y> local_shared_ptr(const local_shared_ptr<Y> &r, T *p) noexcept : ptr(p), cb(r.cb)
+    {
+        if (cb)
+        {
+            cb->addRef();
+        }
+    }
+
+    local_shared_ptr(const local_shared_ptr &r) noexcept : ptr(r.ptr), cb(r.cb)
+    {
+        if (cb)
+        {
+            cb->addRef();
+        }
+    }
+
+    template <typename Y, typename = std::enable_if_t<std::is_convertible<Y *, T *>::value>>
+    local_shared_ptr(const local_shared_ptr<Y> &r) noexcept : ptr(r.ptr), cb(r.cb)
+    {
+        if (cb)
+        {
+            cb->addRef();
+        }
+    }
+
+    local_shared_ptr(local_shared_ptr &&r) noexcept : ptr(r.ptr), cb(r.cb)
+    {
+        r.ptr = nullptr;
+        r.cb = nullptr;
+    }
+
+    template <typename Y, typename = std::enable_if_t<std::is_convertible<Y *, T *>::value>>
+    local_shared_ptr(local_shared_ptr<Y> &&r) noexcept : ptr(r.ptr), cb(r.cb)
+    {
+        r.ptr = nullptr;
+        r.cb = nullptr;
+    }
+
+    template <typename Y> explicit local_shared_ptr(const local_weak_ptr<Y> &r) : ptr(r.ptr), cb(r.cb)
+    {
+        if (!cb || !cb->lock())
+        {
+            throw std::bad_weak_ptr();
+        }
+    }
+
+    ~local_shared_ptr()
+    {
+        if (cb)
+        {
+            cb->release();
+        }
+    }
+
+    local_shared_ptr &operator=(const local_shared_ptr &r) noexcept
+    {
+        local_shared_ptr(r).swap(*this);
+        return *this;
+    }
+
+    local_shared_ptr &operator=(local_shared_ptr &&r) noexcept
+    {
+        local_shared_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept
+    {
+        local_shared_ptr().swap(*this);
+    }
+
+    template <typename Y> void reset(Y *p)
+    {
+        local_shared_ptr(p).swap(*this);
+    }
+
+    void swap(local_shared_ptr &r) noexcept
+    {
+        std::swap(ptr, r.ptr);
+        std::swap(cb, r.cb);
+    }
+
+    T *get() const noexcept
+    {
+        return ptr;
+    }
+    T &operator*() const noexcept
+    {
+        return *ptr;
+    }
+    T *operator->() const noexcept
+    {
+        return ptr;
+    }
+    explicit operator bool() const noexcept
+    {
+        return ptr != nullptr;
+    }
+    long use_count() const noexcept
+    {
+        return cb ? cb->useCount() : 0;
+    }
+
+  private:
+    template <typename U> friend class local_shared_ptr;
+    template <typename U> friend class local_weak_ptr;
+    template <typename U, typename... Args> friend local_shared_ptr<U> make_local_shared(Args &&...args);
+
+    struct Adopt
+    {
+    };
+
+    // adopts a control block that already holds the one strong reference
+    local_shared_ptr(Adopt, T *p, detail::ControlBlock *block) noexcept : ptr(p), cb(block)
+    {
+    }
+
+    template <typename X, typename Y>
+    void enableSharedFromThis(const enable_local_shared_from_this<X> *base, Y *p) noexcept
+    {
+        if (base && base->weakThis.expired())
+        {
+            base->weakThis = local_shared_ptr<X>(*this, static_cast<X *>(p));
+        }
+    }
+    void enableSharedFromThis(...) noexcept
+    {
+    }
+
+    T *ptr = nullptr;
+    detail::ControlBlock *cb = nullptr;
+};
+
+template <typename T> class local_weak_ptr
+{
+  public:
+    constexpr local_weak_ptr() noexcept = default;
+
+    template <typename Y, typename = std::enable_if_t<std::is_convertible<Y *, T *>::value>>
+    local_weak_ptr(const local_shared_ptr<Y> &r) noexcept : ptr(r.ptr), cb(r.cb)
+    {
+        if (cb)
+        {
+            cb->addWeak();
+        }
+    }
+
+    local_weak_ptr(const local_weak_ptr &r) noexcept : ptr(r.ptr), cb(r.cb)
+    {
+        if (cb)
+        {
+            cb->addWeak();
+        }
+    }
+
+    local_weak_ptr(local_weak_ptr &&r) noexcept : ptr(r.ptr), cb(r.cb)
+    {
+        r.ptr = nullptr;
+        r.cb = nullptr;
+    }
+
+    ~local_weak_ptr()
+    {
+        if (cb)
+        {
+            cb->releaseWeak();
+        }
+    }
+
+    local_weak_ptr &operator=(const local_weak_ptr &r) noexcept
+    {
+        local_weak_ptr(r).swap(*this);
+        return *this;
+    }
+
+    local_weak_ptr &operator=(local_weak_ptr &&r) noexcept
+    {
+        local_weak_ptr(std::move(r)).swap(*this);
+        return *this;
+    }
+
+    template <typename Y> local_weak_ptr &operator=(const local_shared_ptr<Y> &r) noexcept
+    {
+        local_weak_ptr(r).swap(*this);
+        return *this;
+    }
+
+    void reset() noexcept
+    {
+        local_weak_ptr().swap(*this);
+    }
+
+    void swap(local_weak_ptr &r) noexcept
+    {
+        std::swap(ptr, r.ptr);
+        std::swap(cb, r.cb);
+    }
+
+    long use_count() const noexcept
+    {
+        return cb ? cb->useCount() : 0;
+    }
+    bool expired() const noexcept
+    {
+        return use_count() == 0;
+    }
+
+    local_shared_ptr<T> lock() const noexcept
+    {
+        if (cb && cb->lock())
+        {
+            return local_shared_ptr<T>(typename local_shared_ptr<T>::Adopt(), ptr, cb);
+        }
+        return local_shared_ptr<T>();
+    }
+
+  private:
+    template <typename U> friend class local_shared_ptr;
+
+    T *ptr = nullptr;
+    detail::ControlBlock *cb = nullptr;
+};
+
+template <typename T> class enable_local_shared_from_this
+{
+  public:
+    local_shared_ptr<T> shared_from_this()
+    {
+        return local_shared_ptr<T>(weakThis); // throws std::bad_weak_ptr if not owned
+    }
+    local_shared_ptr<const T> shared_from_this() const
+    {
+        return local_shared_ptr<const T>(weakThis);
+    }
+    local_weak_ptr<T> weak_from_this() const noexcept
+    {
+        return weakThis;
+    }
+
+  protected:
+    enable_local_shared_from_this() noexcept = default;
+    enable_local_shared_from_this(const enable_local_shared_from_this &) noexcept
+    {
+    }
+    enable_local_shared_from_this &operator=(const enable_local_shared_from_this &) noexcept
+    {
+        return *this;
+    }
+    ~enable_local_shared_from_this() = default;
+
+  private:
+    template <typename U> friend class local_shared_ptr;
+
+    mutable local_weak_ptr<T> weakThis;
+};
+
+template <typename T, typename... Args> local_shared_ptr<T> make_local_shared(Args &&...args)
+{
+    auto block = new detail::InplaceBlock<T>(std::forward<Args>(args)...);
+    local_shared_ptr<T> result(typename local_shared_ptr<T>::Adopt(), block->get(), block);
+    result.enableSharedFromThis(block->get(), block->get());
+    return result;
+}
+
+template <typename T, typename U> bool operator==(const local_shared_ptr<T> &a, const local_shared_ptr<U> &b) noexcept
+{
+    return a.get() == b.get();
+}
+template <typename T, typename U> bool operator!=(const local_shared_ptr<T> &a, const local_shared_ptr<U> &b) noexcept
+{
+    return a.get() != b.get();
+}
+template <typename T> bool operator==(const local_shared_ptr<T> &a, std::nullptr_t) noexcept
+{
+    return !a;
+}
+template <typename T> bool operator!=(const local_shared_ptr<T> &a, std::nullptr_t) noexcept
+{
+    return static_cast<bool>(a);
+}
+} // namespace local
+
+#endif // !__LOCAL_SHARED_PTR_H__
@@ -0,0 +1,496 @@
+#ifndef __MPMC_QUEUE_H__
+#define __MPMC_QUEUE_H__
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Multi-producer/multi-consumer queues for handing objects (typically
+// std::shared_ptrs) to worker threads.
+//
+// BoundedMpmcQueue is the array-based queue by Dmitry Vyukov: every cell
+// carries a sequence number that tells producers and consumers whose turn it
+// is, so a push or pop is one CAS on the shared position plus one store to the
+// cell. SegmentedMpmcQueue chains fixed-size segments and never fails a push;
+// indices are handed out with fetch_add and a consumer that overtakes a
+// producer poisons the cell so the producer moves on. Neither requires T to be
+// default constructible.
+
+namespace mpmc
+{
+constexpr std::size_t cacheLine = 64;
+
+template <typename T> class BoundedMpmcQueue
+{
+  public:
+    explicit BoundedMpmcQueue(std::size_t capacity) : mask(capacity - 1), cells(new Cell[capacity])
+    {
+        assert(capacity >= 2 && (capacity & (capacity - 1)) == 0 && "capacity must be a power of two");
+        for (std::size_t i = 0; i < capacity; ++i)
+        {
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    ~BoundedMpmcQueue()
+    {
+        for (std::size_t pos = dequeuePos.load(); pos != enqueuePos.load(); ++pos)
+        {
+            cells[pos & mask].get()->~T();
+        }
+    }
+
+    BoundedMpmcQueue(const BoundedMpmcQueue &) = delete;
+    BoundedMpmcQueue &operator=(const BoundedMpmcQueue &) = delete;
+
+    bool try_push(T &&item)
+    {
+        std::size_t pos = enqueuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells[pos & mask];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos);
+            if (diff == 0) // cell free for this lap
+            {
+                if (enqueuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    ::new (cell.address()) T(std::move(item));
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if (diff < 0) // cell still holds last lap's item: full
+            {
+                return false;
+            }
+            else
+            {
+                pos = enqueuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T &item)
+    {
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            Cell &cell = cells[pos & mask];
+            std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            auto diff = static_cast<std::ptrdiff_t>(seq) - static_cast<std::ptrdiff_t>(pos + 1);
+            if (diff == 0) // item published for this lap
+            {
+                if (dequeuePos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    take(cell, pos, [&item](T &&value) { item = std::move(value); });
+                    return true;
+                }
+            }
+            else if (diff < 0) // empty
+            {
+                return false;
+            }
+            else
+            {
+                pos = dequeuePos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // claims up to maxItems consecutive published cells with a single CAS and
+    // moves them to out; returns how many were taken
+    template <typename OutIt> std::size_t try_pop_batch(OutIt out, std::size_t maxItems)
+    {
+        if (maxItems == 0)
+        {
+            return 0;
+        }
+        std::size_t pos = dequeuePos.load(std::memory_order_relaxed);
+        for (;;)
+        {
+            std::size_t n = 0;
+            while (n < maxItems && n <= mask &&
+                   cells[(pos + n) & mask].sequence.load(std::memory_order_acquire) == pos + n + 1)
+            {
+                ++n;
+            }
+            if (n == 0)
+            {
+                if (cells[pos & mask].sequence.load(std::memory_order_acquire) <= pos) // empty
+                {
+                    return 0;
+                }
+                pos = dequeuePos.load(std::memory_order_relaxed); // lost a race, retry
+                continue;
+            }
+            if (dequeuePos.compare_exchange_weak(pos, pos + n, std::memory_order_relaxed))
+            {
+                for (std::size_t i = 0; i < n; ++i)
+                {
+                    take(cells[(pos + i) & mask], pos + i, [&out](T &&value) { *out++ = std::move(value); });
+                }
+                return n;
+            }
+        }
+    }
+
+    std::size_t capacity() const noexcept
+    {
+        return mask + 1;
+    }
+
+  private:
+    struct Cell
+    {
+        std::atomic<std::size_t> sequence;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        void *address() noexcept
+        {
+            return &storage;
+        }
+        T *get() noexcept
+        {
+            return std::launder(reinterpret_cast<T *>(&storage));
+        }
+    };
+
+    // hands the item to consume, then frees the cell for the next lap (even if
+    // consume throws)
+    template <typename Consume> void take(Cell &cell, std::size_t pos, Consume consume)
+    {
+        struct Release
+        {
+            Cell &cell;
+            std::size_t nextLap;
+            ~Release()
+            {
+                cell.get()->~T();
+                cell.sequence.store(nextLap, std::memory_order_release);
+            }
+        } release{cell, pos + mask + 1};
+        consume(std::move(*cell.get()));
+    }
+
+    const std::size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(cacheLine) std::atomic<std::size_t> enqueuePos{0};
+    alignas(cacheLine) std::atomic<std::size_t> dequeuePos{0};
+};
+
+// Unbounded queue made of fixed-size segments.
+// A drained segment is unlinked and retired, and freed once no thread is
+// reading it: every push or pop announces the segment it works on in a hazard
+// pointer (Maged Michael's scheme), and retire() frees the retired segments
+// nobody announces. The queue thus holds its live segments plus a few retired
+// ones per thread, however long it lives.
+template <typename T, std::size_t SegmentSize = 1024> class SegmentedMpmcQueue
+{
+  public:
+    SegmentedMpmcQueue() : head(newSegment()), tail(head.load())
+    {
+    }
+
+    ~SegmentedMpmcQueue()
+    {
+        for (Segment *seg = head.load(); seg != nullptr;)
+        {
+            for (Slot &slot : seg->slots)
+            {
+                if (slot.state.load() == ready)
+                {
+                    slot.get()->~T();
+                }
+            }
+            Segment *next = seg->next.load();
+            deleteSegment(seg);
+            seg = next;
+        }
+        for (Segment *seg : retired)
+        {
+            deleteSegment(seg);
+        }
+        for (HazardRecord *r = hazards.load(); r != nullptr;)
+        {
+            HazardRecord *next = r->next;
+            delete r;
+            r = next;
+        }
+    }
+
+    SegmentedMpmcQueue(const SegmentedMpmcQueue &) = delete;
+    SegmentedMpmcQueue &operator=(const SegmentedMpmcQueue &) = delete;
+
+    void push(T &&item)
+    {
+        HazardGuard guard(*this);
+        for (;;)
+        {
+            Segment *seg = guard.protect(tail);
+            std::size_t idx = seg->enqueueIdx.fetch_add(1, std::memory_order_acq_rel);
+            if (idx < SegmentSize)
+            {
+                Slot &slot = seg->slots[idx];
+                int expected = empty;
+                if (slot.state.compare_exchange_strong(expected, writing, std::memory_order_acq_rel))
+                {
+                    ::new (slot.address()) T(std::move(item));
+                    slot.state.store(ready, std::memory_order_release);
+                    return;
+                }
+                continue; // a consumer gave up on this slot, take the next index
+            }
+
+            // segment full: link a new one (or help whoever already did) and move tail on
+            Segment *next = seg->next.load(std::memory_order_acquire);
+            if (next == nullptr)
+            {
+                Segment *fresh = newSegment();
+                if (seg->next.compare_exchange_strong(next, fresh, std::memory_order_acq_rel))
+                {
+                    next = fresh;
+                }
+                else
+                {
+                    deleteSegment(fresh);
+                }
+            }
+            tail.compare_exchange_strong(seg, next, std::memory_order_acq_rel);
+        }
+    }
+
+    bool try_pop(T &item)
+    {
+        HazardGuard guard(*this);
+        return popOne(guard, [&item](T &&value) { item = std::move(value); });
+    }
+
+    template <typename OutIt> std::size_t try_pop_batch(OutIt out, std::size_t maxItems)
+    {
+        HazardGuard guard(*this);
+        std::size_t n = 0;
+        while (n < maxItems && popOne(guard, [&out](T &&value) { *out++ = std::move(value); }))
+        {
+            ++n;
+        }
+        return n;
+    }
+
+    // segments allocated and not yet freed, linked or retired
+    std::size_t segments() const noexcept
+    {
+        return segmentCount.load(std::memory_order_relaxed);
+    }
+
+  private:
+    enum : int
+    {
+        empty,
+        writing,
+        ready,
+        taken
+    };
+
+    struct Slot
+    {
+        std::atomic<int> state{empty};
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+        void *address() noexcept
+        {
+            return &storage;
+        }
+        T *get() noexcept
+        {
+            return std::launder(reinterpret_cast<T *>(&storage));
+        }
+    };
+
+    struct Segment
+    {
+        alignas(cacheLine) std::atomic<std::size_t> enqueueIdx{0};
+        alignas(cacheLine) std::atomic<std::size_t> dequeueIdx{0};
+        std::atomic<Segment *> next{nullptr};
+        Slot slots[SegmentSize];
+    };
+
+    // one per thread in an operation at the same time; never freed before the queue
+    struct HazardRecord
+    {
+        alignas(cacheLine) std::atomic<Segment *> segment{nullptr};
+        std::atomic<bool> inUse{true};
+        HazardRecord *next = nullptr;
+    };
+
+    // holds a hazard record for the length of one push or pop
+    class HazardGuard
+    {
+      public:
+        explicit HazardGuard(SegmentedMpmcQueue &queue) : record(queue.acquireRecord())
+        {
+        }
+
+        ~HazardGuard()
+        {
+            record.segment.store(nullptr, std::memory_order_release);
+            record.inUse.store(false, std::memory_order_release);
+        }
+
+        HazardGuard(const HazardGuard &) = delete;
+        HazardGuard &operator=(const HazardGuard &) = delete;
+
+        // the segment src points to, safe to use until the next protect()
+        Segment *protect(const std::atomic<Segment *> &src) noexcept
+        {
+            Segment *seg = src.load(std::memory_order_acquire);
+            for (;;)
+            {
+                record.segment.store(seg, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in retire()
+                Segment *again = src.load(std::memory_order_acquire);
+                if (again == seg) // still linked, so not retired before the announcement
+                {
+                    return seg;
+                }
+                seg = again;
+            }
+        }
+
+      private:
+        HazardRecord &record;
+    };
+
+    template <typename Consume> bool popOne(HazardGuard &guard, Consume consume)
+    {
+        for (;;)
+        {
+            Segment *seg = guard.protect(head);
+            if (seg->dequeueIdx.load(std::memory_order_acquire) >= seg->enqueueIdx.load(std::memory_order_acquire) &&
+                seg->next.load(std::memory_order_acquire) == nullptr)
+            {
+                return false; // nothing published or in flight
+            }
+            std::size_t idx = seg->dequeueIdx.fetch_add(1, std::memory_order_acq_rel);
+            if (idx < SegmentSize)
+            {
+                Slot &slot = seg->slots[idx];
+                int expected = empty;
+                if (slot.state.compare_exchange_strong(expected, taken, std::memory_order_acq_rel))
+                {
+                    continue; // overtook the producer: the slot is poisoned, try the next one
+                }
+                while (slot.state.load(std::memory_order_acquire) != ready) // producer is mid-write
+                {
+                    std::this_thread::yield();
+                }
+                struct Release
+                {
+                    Slot &slot;
+                    ~Release()
+                    {
+                        slot.get()->~T();
+                        slot.state.store(taken, std::memory_order_release);
+                    }
+                } release{slot};
+                consume(std::move(*slot.get()));
+                return true;
+            }
+
+            Segment *next = seg->next.load(std::memory_order_acquire);
+            if (next == nullptr)
+            {
+                return false;
+            }
+            Segment *expectedTail = seg; // never leave tail behind head
+            tail.compare_exchange_strong(expectedTail, next, std::memory_order_acq_rel);
+            if (head.compare_exchange_strong(seg, next, std::memory_order_acq_rel))
+            {
+                retire(seg);
+            }
+        }
+    }
+
+    HazardRecord &acquireRecord()
+    {
+        for (HazardRecord *r = hazards.load(std::memory_order_acquire); r != nullptr; r = r->next)
+        {
+            bool expected = false;
+            if (!r->inUse.load(std::memory_order_relaxed) &&
+                r->inUse.compare_exchange_strong(expected, true, std::memory_order_acquire))
+            {
+                return *r;
+            }
+        }
+        HazardRecord *r = new HazardRecord; // all in use: one more thread than ever before
+        hazardCount.fetch_add(1, std::memory_order_relaxed);
+        HazardRecord *first = hazards.load(std::memory_order_relaxed);
+        do
+        {
+            r->next = first;
+        } while (!hazards.compare_exchange_weak(first, r, std::memory_order_release, std::memory_order_relaxed));
+        return *r;
+    }
+
+    // seg is unlinked from head and tail: free it, and the other retired
+    // segments, once no hazard pointer names them
+    void retire(Segment *seg)
+    {
+        std::lock_guard<std::mutex> guard{retiredMutex}; // once per SegmentSize items
+        retired.push_back(seg);
+        if (retired.size() < 2 * hazardCount.load(std::memory_order_relaxed) + 2) // scan when half can go
+        {
+            return;
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst); // pairs with the fence in protect()
+        std::vector<Segment *> announced;
+        for (HazardRecord *r = hazards.load(std::memory_order_acquire); r != nullptr; r = r->next)
+        {
+            if (Segment *s = r->segment.load(std::memory_order_relaxed))
+            {
+                announced.push_back(s);
+            }
+        }
+        std::sort(announced.begin(), announced.end());
+        auto unused = std::partition(retired.begin(), retired.end(), [&announced](Segment *s) {
+            return std::binary_search(announced.begin(), announced.end(), s);
+        });
+        for (auto it = unused; it != retired.end(); ++it)
+        {
+            deleteSegment(*it);
+        }
+        retired.erase(unused, retired.end());
+    }
+
+    Segment *newSegment()
+    {
+        Segment *seg = new Segment;
+        segmentCount.fetch_add(1, std::memory_order_relaxed);
+        return seg;
+    }
+
+    void deleteSegment(Segment *seg) noexcept
+    {
+        segmentCount.fetch_sub(1, std::memory_order_relaxed);
+        delete seg;
+    }
+
+    std::atomic<std::size_t> segmentCount{0}; // before head, which newSegment() initializes
+    alignas(cacheLine) std::atomic<Segment *> head;
+    alignas(cacheLine) std::atomic<Segment *> tail;
+    std::atomic<HazardRecord *> hazards{nullptr};
+    std::atomic<std::size_t> hazardCount{0};
+    std::mutex retiredMutex;
+    std::vector<Segment *> retired;
+};
+} // namespace mpmc
+
+#endif // !__MPMC_QUEUE_H__
@@ -0,0 +1,256 @@
+#include "../Item24/counting_new.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Overhead of std::unique_ptr (Item 18) and std::shared_ptr (Item 19) by
+// deleter kind, as a small Google-Benchmark-style suite.
+// • Every case measures construction, move, destruction and dereference per
+// pointer, plus the memory footprint of a million pointers.
+// • Console output by default; --benchmark_format=json prints JSON and
+// --benchmark_out=<file> writes it to a file, in the same layout Google
+// Benchmark uses, so the results can be diffed between runs.
+
+namespace bench
+{
+struct Result
+{
+    std::string name;
+    std::size_t iterations;
+    double nsPerOp;
+    std::size_t bytes; // footprint entries only
+};
+
+class Suite
+{
+  public:
+    // round() performs one batch and returns the nanoseconds spent on the timed
+    // part of it; rounds are repeated until minTime has been accumulated
+    template <typename Round> void run(const std::string &name, std::size_t opsPerRound, Round round)
+    {
+        round(); // warm-up
+        double totalNs = 0;
+        std::size_t rounds = 0;
+        while (totalNs < minTimeNs || rounds < 3)
+        {
+            totalNs += round();
+            ++rounds;
+        }
+        results.push_back({name, rounds * opsPerRound, totalNs / (rounds * opsPerRound), 0});
+    }
+
+    void footprint(const std::string &name, std::size_t bytes)
+    {
+        results.push_back({name, 1, 0, bytes});
+    }
+
+    void printConsole() const
+    {
+        printf("%-40s %12s %14s %16s\n", "Benchmark", "Time", "Iterations", "Bytes");
+        for (const auto &r : results)
+        {
+            if (r.bytes)
+            {
+                printf("%-40s %12s %14s %16zu\n", r.name.c_str(), "-", "-", r.bytes);
+            }
+            else
+            {
+                printf("%-40s %9.2f ns %14zu %16s\n", r.name.c_str(), r.nsPerOp, r.iterations, "-");
+            }
+        }
+    }
+
+    void printJson(FILE *out) const
+    {
+        fprintf(out, "{\n  \"context\": {\n");
+        fprintf(out, "    \"executable\": \"smart_ptr_overhead\",\n");
+        fprintf(out, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+#ifdef NDEBUG
+        fprintf(out, "    \"library_build_type\": \"release\"\n");
+#else
+        fprintf(out, "    \"library_build_type\": \"debug\"\n");
+#endif
+        fprintf(out, "  },\n  \"benchmarks\": [\n");
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const auto &r = results[i];
+            fprintf(out, "    {\"name\": \"%s\", \"run_type\": \"iteration\", \"iterations\": %zu, ", r.name.c_str(),
+                    r.iterations);
+            fprintf(out, "\"real_time\": %.4f, \"cpu_time\": %.4f, \"time_unit\": \"ns\"", r.nsPerOp, r.nsPerOp);
+            if (r.bytes)
+            {
+                fprintf(out, ", \"bytes\": %zu", r.bytes);
+            }
+            fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+        }
+        fprintf(out, "  ]\n}\n");
+    }
+
+  private:
+    static constexpr double minTimeNs = 50e6; // 50 ms per benchmark
+    std::vector<Result> results;
+};
+
+template <typename F> double timeNs(F &&f)
+{
+    auto start = std::chrono::steady_clock::now();
+    f();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+// the four per-pointer measurements plus the footprint, for any pointer type
+// produced by make(int)
+template <typename Ptr, typename Make> void addPointerBenchmarks(Suite &suite, const std::string &name, Make make)
+{
+    constexpr std::size_t batch = 1024;
+
+    suite.run(name + "/construct", batch, [&] {
+        std::vector<Ptr> v;
+        v.reserve(batch);
+        return timeNs([&] {
+            for (std::size_t i = 0; i < batch; ++i)
+            {
+                v.push_back(make(static_cast<int>(i)));
+            }
+        });
+    });
+
+    suite.run(name + "/move", batch, [&] {
+        std::vector<Ptr> src, dst;
+        src.reserve(batch);
+        dst.reserve(batch);
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            src.push_back(make(static_cast<int>(i)));
+        }
+        return timeNs([&] {
+            for (auto &p : src)
+            {
+                dst.push_back(std::move(p));
+            }
+        });
+    });
+
+    suite.run(name + "/destroy", batch, [&] {
+        std::vector<Ptr> v;
+        v.reserve(batch);
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            v.push_back(make(static_cast<int>(i)));
+        }
+        return timeNs([&] { v.clear(); });
+    });
+
+    {
+        std::vector<Ptr> v;
+        v.reserve(batch);
+        for (std::size_t i = 0; i < batch; ++i)
+        {
+            v.push_back(make(static_cast<int>(i)));
+        }
+        volatile long sink = 0;
+        suite.run(name + "/deref", batch, [&] {
+            return timeNs([&] {
+                long sum = 0;
+                for (const auto &p : v)
+                {
+                    sum += *p;
+                }
+                sink = sink + sum;
+            });
+        });
+    }
+
+    // vector storage plus every heap allocation the pointers make
+    constexpr std::size_t million = 1000000;
+    std::size_t before = counting_new::requestedBytes;
+    {
+        std::vector<Ptr> v;
+        v.reserve(million);
+        for (std::size_t i = 0; i < million; ++i)
+        {
+            v.push_back(make(static_cast<int>(i)));
+        }
+        suite.footprint(name + "/footprint_1M", counting_new::requestedBytes - before);
+    }
+}
+
+auto lambdaDel = [](int *p) { delete p; };
+void functionDel(int *p)
+{
+    delete p;
+}
+
+using UniqueDefault = std::unique_ptr<int>;
+using UniqueLambda = std::unique_ptr<int, decltype(lambdaDel)>;
+using UniqueFnPtr = std::unique_ptr<int, void (*)(int *)>;
+using UniqueFunction = std::unique_ptr<int, std::function<void(int *)>>;
+
+void registerAll(Suite &suite)
+{
+    addPointerBenchmarks<UniqueDefault>(suite, "unique_ptr<default_delete>",
+                                        [](int i) { return UniqueDefault(new int(i)); });
+    addPointerBenchmarks<UniqueLambda>(suite, "unique_ptr<lambda>",
+                                       [](int i) { return UniqueLambda(new int(i), lambdaDel); });
+    addPointerBenchmarks<UniqueFnPtr>(suite, "unique_ptr<fn_ptr>",
+                                      [](int i) { return UniqueFnPtr(new int(i), functionDel); });
+    addPointerBenchmarks<UniqueFunction>(suite, "unique_ptr<std::function>",
+                                         [](int i) { return UniqueFunction(new int(i), lambdaDel); });
+
+    addPointerBenchmarks<std::shared_ptr<int>>(suite, "shared_ptr(new)",
+                                               [](int i) { return std::shared_ptr<int>(new int(i)); });
+    addPointerBenchmarks<std::shared_ptr<int>>(suite, "shared_ptr(new, lambda)",
+                                               [](int i) { return std::shared_ptr<int>(new int(i), lambdaDel); });
+    addPointerBenchmarks<std::shared_ptr<int>>(suite, "make_shared", [](int i) { return std::make_shared<int>(i); });
+}
+} // namespace bench
+
+int main(int argc, char **argv)
+{
+    bool json = false;
+    const char *outPath = nullptr;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--benchmark_format=json") == 0)
+        {
+            json = true;
+        }
+        else if (std::strncmp(argv[i], "--benchmark_out=", 16) == 0)
+        {
+            outPath = argv[i] + 16;
+        }
+    }
+
+    bench::Suite suite;
+    bench::registerAll(suite);
+
+    if (json)
+    {
+        suite.printJson(stdout);
+    }
+    else
+    {
+        suite.printConsole();
+    }
+    if (outPath)
+    {
+        if (FILE *f = std::fopen(outPath, "w"))
+        {
+            suite.printJson(f);
+            std::fclose(f);
+        }
+        else
+        {
+            fprintf(stderr, "cannot open %s\n", outPath);
+            return 1;
+        }
+    }
+    return 0;
+}
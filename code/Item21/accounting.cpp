@@ -0,0 +1,123 @@
+#include "../Item24/churn.h"
+#include "accounting_allocator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// Where do make_shared's bytes go? test_allocate_shared in use_make_shared.cpp
+// with accounting::AccountingAllocator instead of std::allocator: control
+// blocks, live objects and weak-pinned storage, per tag.
+
+class Widget
+{
+  public:
+    explicit Widget(long v = 0) : payload(v)
+    {
+    }
+    long payload;
+};
+
+class ReallyBigType
+{
+  public:
+    char data[1 << 16] = {};
+};
+
+struct IntTag
+{
+    static constexpr const char *name = "int";
+};
+
+struct WidgetTag
+{
+    static constexpr const char *name = "Widget";
+};
+
+struct BigTag
+{
+    static constexpr const char *name = "ReallyBigType";
+};
+
+struct UnaccountedTag
+{
+    static constexpr const char *name = "unaccounted";
+};
+
+template <> constexpr bool accounting::enabled<UnaccountedTag> = false;
+
+void test_allocate_shared()
+{
+    auto p = std::allocate_shared<int>(accounting::AccountingAllocator<int, IntTag>(), 42);
+    printf("p=%d\n", *p);
+}
+
+void test_snapshot()
+{
+    std::vector<std::shared_ptr<Widget>> widgets;
+    for (long i = 0; i < 100; ++i)
+    {
+        widgets.push_back(accounting::make_shared<Widget, WidgetTag>(i));
+    }
+
+    auto pBigObj = accounting::make_shared<ReallyBigType, BigTag>();
+    std::weak_ptr<ReallyBigType> observer = pBigObj;
+    printf("-- 100 widgets and one ReallyBigType alive\n");
+    accounting::dump();
+
+    pBigObj.reset(); // the weak_ptr now pins the 64 KiB
+    widgets.resize(10);
+    printf("-- 10 widgets alive, ReallyBigType only weakly referenced\n");
+    accounting::dump();
+
+    for (const accounting::Snapshot &s : accounting::snapshot())
+    {
+        if (s.weakRetainedBytes > 0)
+        {
+            printf("%s: %zu B held only by weak_ptrs\n", s.tag, s.weakRetainedBytes);
+        }
+    }
+}
+
+void test_periodic_dump()
+{
+    printf("-- dump every 100 ms while widgets come and go\n");
+    accounting::PeriodicDump reporter(std::chrono::milliseconds(100));
+    std::vector<std::shared_ptr<Widget>> widgets;
+    for (int step = 0; step < 3; ++step)
+    {
+        for (long i = 0; i < 1000; ++i)
+        {
+            widgets.push_back(accounting::make_shared<Widget, WidgetTag>(i));
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(110));
+    }
+}
+
+void benchmark()
+{
+    constexpr std::size_t rounds = 10000;
+    unsigned maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    printf("%8s %14s %14s %14s   (M create+destroy/s)\n", "threads", "make_shared", "disabled", "enabled");
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        double plain = timing::churn(threads, rounds, [](long v) { return std::make_shared<Widget>(v); });
+        double off =
+            timing::churn(threads, rounds, [](long v) { return accounting::make_shared<Widget, UnaccountedTag>(v); });
+        double on =
+            timing::churn(threads, rounds, [](long v) { return accounting::make_shared<Widget, WidgetTag>(v); });
+        printf("%8u %14.2f %14.2f %14.2f\n", threads, plain, off, on);
+    }
+}
+
+int main()
+{
+    test_allocate_shared();
+    test_snapshot();
+    test_periodic_dump();
+    benchmark();
+    return 0;
+}
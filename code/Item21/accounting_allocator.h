@@ -0,0 +1,262 @@
+#ifndef __ACCOUNTING_ALLOCATOR_H__
+#define __ACCOUNTING_ALLOCATOR_H__
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Per-tag accounting for std::allocate_shared.
+//
+// AccountingAllocator<T, Tag> sees every step of a co-allocated shared object:
+// the block (control block + object) is allocated, the object constructed, the
+// object destroyed with the last shared_ptr, the block deallocated with the
+// last weak_ptr. From that it keeps, per Tag:
+// • liveObjects: objects constructed and not yet destroyed
+// • controlBlockBytes: bytes of live blocks that are not the object itself
+// • weakRetainedBytes/Objects: object storage kept alive only by weak_ptrs
+//
+// A tag is any type with a static name:
+//     struct WidgetTag { static constexpr const char *name = "Widget"; };
+// Specialize accounting::enabled<WidgetTag> to false to compile the counting out.
+
+namespace accounting
+{
+template <typename Tag> constexpr bool enabled = true;
+
+struct Snapshot
+{
+    const char *tag;
+    std::size_t liveObjects;
+    std::size_t controlBlockBytes;
+    std::size_t weakRetainedObjects;
+    std::size_t weakRetainedBytes;
+};
+
+namespace detail
+{
+// one cache line per tag so that tags don't contend with each other
+struct alignas(64) Counters
+{
+    std::atomic<std::size_t> liveObjects{0};
+    std::atomic<std::size_t> controlBlockBytes{0};
+    std::atomic<std::size_t> weakRetainedObjects{0};
+    std::atomic<std::size_t> weakRetainedBytes{0};
+};
+
+class Registry
+{
+  public:
+    void add(const char *tag, const Counters *counters)
+    {
+        std::lock_guard<std::mutex> guard{m};
+        entries.push_back({tag, counters});
+    }
+
+    std::vector<Snapshot> snapshot() const
+    {
+        std::lock_guard<std::mutex> guard{m};
+        std::vector<Snapshot> result;
+        result.reserve(entries.size());
+        for (const auto &e : entries)
+        {
+            result.push_back({e.tag, e.counters->liveObjects.load(std::memory_order_relaxed),
+                              e.counters->controlBlockBytes.load(std::memory_order_relaxed),
+                              e.counters->weakRetainedObjects.load(std::memory_order_relaxed),
+                              e.counters->weakRetainedBytes.load(std::memory_order_relaxed)});
+        }
+        return result;
+    }
+
+  private:
+    struct Entry
+    {
+        const char *tag;
+        const Counters *counters;
+    };
+
+    mutable std::mutex m;
+    std::vector<Entry> entries;
+};
+
+inline Registry &registry()
+{
+    static Registry r;
+    return r;
+}
+
+// created and registered on first use of the tag
+template <typename Tag> Counters &counters()
+{
+    struct Registered
+    {
+        Registered()
+        {
+            registry().add(Tag::name, &c);
+        }
+        Counters c;
+    };
+    static Registered r;
+    return r.c;
+}
+
+inline void add(std::atomic<std::size_t> &counter, std::size_t n) noexcept
+{
+    counter.fetch_add(n, std::memory_order_relaxed);
+}
+
+inline void sub(std::atomic<std::size_t> &counter, std::size_t n) noexcept
+{
+    counter.fetch_sub(n, std::memory_order_relaxed);
+}
+} // namespace detail
+
+// counters of every tag used so far; each value is read separately, so a
+// snapshot taken under load is approximate
+inline std::vector<Snapshot> snapshot()
+{
+    return detail::registry().snapshot();
+}
+
+inline void dump(std::FILE *out = stdout)
+{
+    std::fprintf(out, "%-16s %12s %16s %14s %16s\n", "tag", "live objects", "ctrl block B", "weak objects",
+                 "weak retained B");
+    for (const Snapshot &s : snapshot())
+    {
+        std::fprintf(out, "%-16s %12zu %16zu %14zu %16zu\n", s.tag, s.liveObjects, s.controlBlockBytes,
+                     s.weakRetainedObjects, s.weakRetainedBytes);
+    }
+}
+
+// dumps every period on a background thread until destroyed
+class PeriodicDump
+{
+  public:
+    explicit PeriodicDump(std::chrono::milliseconds period, std::FILE *out = stdout)
+        : worker([this, period, out] {
+              std::unique_lock<std::mutex> lock{m};
+              while (!cv.wait_for(lock, period, [this] { return stopping; }))
+              {
+                  dump(out);
+              }
+          })
+    {
+    }
+
+    ~PeriodicDump()
+    {
+        {
+            std::lock_guard<std::mutex> guard{m};
+            stopping = true;
+        }
+        cv.notify_one();
+        worker.join();
+    }
+
+    PeriodicDump(const PeriodicDump &) = delete;
+    PeriodicDump &operator=(const PeriodicDump &) = delete;
+
+  private:
+    std::mutex m;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::thread worker; // last, so it starts after the members above exist
+};
+
+// Obj is the type given to allocate_shared; rebinding keeps it, so the
+// allocator can tell the control-block allocation from anything else.
+// Storage of a block that holds no live object (before construction, after
+// destruction) counts as weak-retained, which keeps the numbers right even if
+// the constructor throws.
+template <typename T, typename Tag, typename Obj = T> class AccountingAllocator
+{
+  public:
+    using value_type = T;
+
+    template <typename U> struct rebind
+    {
+        using other = AccountingAllocator<U, Tag, Obj>;
+    };
+
+    AccountingAllocator() noexcept = default;
+    template <typename U> AccountingAllocator(const AccountingAllocator<U, Tag, Obj> &) noexcept
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        T *p = std::allocator<T>().allocate(n);
+        if constexpr (enabled<Tag> && !std::is_same<T, Obj>::value)
+        {
+            detail::Counters &c = detail::counters<Tag>();
+            detail::add(c.controlBlockBytes, n * (sizeof(T) - sizeof(Obj)));
+            detail::add(c.weakRetainedObjects, n);
+            detail::add(c.weakRetainedBytes, n * sizeof(Obj));
+        }
+        return p;
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+        if constexpr (enabled<Tag> && !std::is_same<T, Obj>::value)
+        {
+            detail::Counters &c = detail::counters<Tag>();
+            detail::sub(c.controlBlockBytes, n * (sizeof(T) - sizeof(Obj)));
+            detail::sub(c.weakRetainedObjects, n);
+            detail::sub(c.weakRetainedBytes, n * sizeof(Obj));
+        }
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U, typename... Args> void construct(U *p, Args &&...args)
+    {
+        ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+        if constexpr (enabled<Tag> && std::is_same<std::remove_cv_t<U>, Obj>::value)
+        {
+            detail::Counters &c = detail::counters<Tag>();
+            detail::add(c.liveObjects, 1);
+            detail::sub(c.weakRetainedObjects, 1);
+            detail::sub(c.weakRetainedBytes, sizeof(Obj));
+        }
+    }
+
+    template <typename U> void destroy(U *p)
+    {
+        p->~U();
+        if constexpr (enabled<Tag> && std::is_same<std::remove_cv_t<U>, Obj>::value)
+        {
+            detail::Counters &c = detail::counters<Tag>();
+            detail::sub(c.liveObjects, 1);
+            detail::add(c.weakRetainedObjects, 1);
+            detail::add(c.weakRetainedBytes, sizeof(Obj));
+        }
+    }
+};
+
+template <typename T, typename U, typename Tag, typename Obj>
+bool operator==(const AccountingAllocator<T, Tag, Obj> &, const AccountingAllocator<U, Tag, Obj> &) noexcept
+{
+    return true;
+}
+template <typename T, typename U, typename Tag, typename Obj>
+bool operator!=(const AccountingAllocator<T, Tag, Obj> &, const AccountingAllocator<U, Tag, Obj> &) noexcept
+{
+    return false;
+}
+
+// make_shared, accounted under Tag
+template <typename T, typename Tag, typename... Ts> std::shared_ptr<T> make_shared(Ts &&...params)
+{
+    return std::allocate_shared<T>(AccountingAllocator<T, Tag>(), std::forward<Ts>(params)...);
+}
+} // namespace accounting
+
+#endif // !__ACCOUNTING_ALLOCATOR_H__
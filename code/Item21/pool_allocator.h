@@ -0,0 +1,61 @@
+#ifndef __POOL_ALLOCATOR_H__
+#define __POOL_ALLOCATOR_H__
+
+#include "../Item18/slab_pool.h"
+#include <cstddef>
+#include <new>
+
+// A stateless allocator on top of the slab pool of Item18/slab_pool.h, meant
+// for std::allocate_shared.
+//
+// allocate_shared rebinds the allocator to its internal control-block type,
+// which has the object embedded, and asks for exactly one of those. So every
+// allocate(1) the pool sees is "control block + object" in one block, and all
+// blocks of one size class are carved from the same slabs.
+
+namespace pool
+{
+// stateless, so every instance compares equal and rebinding is free
+template <typename T> class PoolAllocator
+{
+  public:
+    using value_type = T;
+
+    PoolAllocator() noexcept = default;
+    template <typename U> PoolAllocator(const PoolAllocator<U> &) noexcept
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        if (n == 1)
+        {
+            return static_cast<T *>(pooled::SlabPool<sizeof(T), alignof(T)>::allocate());
+        }
+        return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignof(T))));
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+        if (n == 1)
+        {
+            pooled::SlabPool<sizeof(T), alignof(T)>::deallocate(p);
+        }
+        else
+        {
+            ::operator delete(p, std::align_val_t(alignof(T)));
+        }
+    }
+};
+
+template <typename T, typename U> bool operator==(const PoolAllocator<T> &, const PoolAllocator<U> &) noexcept
+{
+    return true;
+}
+template <typename T, typename U> bool operator!=(const PoolAllocator<T> &, const PoolAllocator<U> &) noexcept
+{
+    return false;
+}
+} // namespace pool
+
+#endif // !__POOL_ALLOCATOR_H__
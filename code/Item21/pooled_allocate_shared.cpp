@@ -0,0 +1,111 @@
+#include "../Item24/churn.h"
+#include "pool_allocator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+#include <thread>
+#include <vector>
+
+// std::allocate_shared with a pooling allocator.
+// • make_shared already puts the control block and the object in one
+// allocation; allocate_shared with pool::PoolAllocator also takes that
+// allocation from a per-thread free list instead of the general-purpose heap.
+// • Widget2::create() (the factory from Item 19) keeps its private constructor:
+// allocate_shared constructs through the allocator, which is not a friend, so
+// the constructor is public but takes a private Token only create() can make.
+
+namespace with_make_shared
+{
+class Widget2 : public std::enable_shared_from_this<Widget2>
+{
+    struct Token
+    {
+    };
+
+  public:
+    explicit Widget2(Token, long v = 0) : payload(v)
+    {
+    }
+
+    void process(std::vector<std::shared_ptr<Widget2>> &processed)
+    {
+        processed.emplace_back(shared_from_this());
+    }
+
+    template <typename... Ts> static std::shared_ptr<Widget2> create(Ts &&...args)
+    {
+        return std::make_shared<Widget2>(Token{}, std::forward<Ts>(args)...);
+    }
+
+    long payload;
+    double state[4] = {};
+};
+} // namespace with_make_shared
+
+namespace with_pool
+{
+class Widget2 : public std::enable_shared_from_this<Widget2>
+{
+    struct Token
+    {
+    };
+
+  public:
+    explicit Widget2(Token, long v = 0) : payload(v)
+    {
+    }
+
+    void process(std::vector<std::shared_ptr<Widget2>> &processed)
+    {
+        processed.emplace_back(shared_from_this());
+    }
+
+    template <typename... Ts> static std::shared_ptr<Widget2> create(Ts &&...args)
+    {
+        return std::allocate_shared<Widget2>(pool::PoolAllocator<Widget2>(), Token{}, std::forward<Ts>(args)...);
+    }
+
+    long payload;
+    double state[4] = {};
+};
+} // namespace with_pool
+
+void test_pooled_create()
+{
+    using with_pool::Widget2;
+
+    std::vector<std::shared_ptr<Widget2>> processed;
+    auto spw = Widget2::create(42);
+    spw->process(processed); // shared_from_this works as with make_shared
+    printf("payload = %ld, use_count = %ld\n", spw->payload, spw.use_count()); // 42, 2
+
+    // auto bad = std::allocate_shared<Widget2>(pool::PoolAllocator<Widget2>()); // error: Token is private
+
+    Widget2 *first = spw.get();
+    processed.clear();
+    spw.reset();               // control block + object go back to this thread's cache
+    spw = Widget2::create(43); // and come straight out again
+    printf("block reused: %d\n", spw.get() == first);
+}
+
+void benchmark()
+{
+    constexpr std::size_t rounds = 20000; // 1.28M create/destroy cycles per thread
+    unsigned maxThreads = std::max(4u, std::thread::hardware_concurrency());
+    for (unsigned threads = 1; threads <= maxThreads; threads *= 2)
+    {
+        double heapRate = timing::churn(threads, rounds, [](long v) { return with_make_shared::Widget2::create(v); });
+        double poolRate = timing::churn(threads, rounds, [](long v) { return with_pool::Widget2::create(v); });
+        printf("%2u thread(s): make_shared %7.2f M create+destroy/s, pooled allocate_shared %7.2f M create+destroy/s\n",
+               threads, heapRate, poolRate);
+    }
+}
+
+int main()
+{
+    test_pooled_create();
+    benchmark();
+    return 0;
+}
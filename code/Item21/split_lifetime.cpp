@@ -0,0 +1,105 @@
+#include "../Item24/counting_new.h"
+#include "weak_retention.h"
+#include <cstddef>
+#include <cstdio>
+#include <memory>
+
+// test_ReallyBigType and test_ReallyBigType2 from use_make_shared.cpp, with
+// numbers: the heap bytes still in use after the last shared_ptr is gone while
+// a weak_ptr remains, for make_shared and for retention::make_shared_for.
+
+class ReallyBigType
+{
+  public:
+    char data[1 << 20] = {};
+};
+
+class SmallType
+{
+  public:
+    long value = 0;
+};
+
+void printHook(std::ptrdiff_t delta, std::size_t total)
+{
+    printf("    [hook] weak-retained %+td B, now %zu B\n", delta, total);
+}
+
+std::size_t hookCalls = 0;
+
+void countHook(std::ptrdiff_t, std::size_t)
+{
+    ++hookCalls;
+}
+
+template <typename MakeFunc> void reproduce(const char *name, MakeFunc make)
+{
+    std::size_t before = counting_new::liveBytes;
+    auto pBigObj = make();
+    std::weak_ptr<ReallyBigType> wpBigObj = pBigObj;
+    printf("%s\n  while in use:               %8zu B on the heap\n", name, counting_new::liveBytes - before);
+
+    pBigObj.reset(); // final shared_ptr destroyed, the weak_ptr remains
+    printf("  last shared_ptr gone:       %8zu B on the heap, %zu B weak-retained, expired = %d\n",
+           counting_new::liveBytes - before, retention::retainedBytes(), wpBigObj.expired());
+
+    wpBigObj.reset(); // final weak_ptr destroyed
+    printf("  last weak_ptr gone:         %8zu B on the heap, %zu B weak-retained\n", counting_new::liveBytes - before,
+           retention::retainedBytes());
+}
+
+void test_ReallyBigType_retention()
+{
+    using namespace retention;
+
+    setHook(printHook);
+    // forced co-allocation: the 1 MiB stays until the weak_ptr dies
+    reproduce("make_shared_for (co-allocated)", [] { return make_shared_for<ReallyBigType>(WeakRefs::shortLived); });
+    // large and with lingering weak_ptrs: split, released with the last shared_ptr
+    reproduce("make_shared_for (split)", [] { return make_shared_for<ReallyBigType>(WeakRefs::outliveObject); });
+    setHook(nullptr);
+}
+
+void test_layout_choice()
+{
+    using namespace retention;
+
+    printf("SmallType,     weak refs outlive object: co-allocate = %d\n",
+           coallocate<SmallType>(WeakRefs::outliveObject));
+    printf("ReallyBigType, weak refs short-lived:    co-allocate = %d\n",
+           coallocate<ReallyBigType>(WeakRefs::shortLived));
+    printf("ReallyBigType, weak refs outlive object: co-allocate = %d\n",
+           coallocate<ReallyBigType>(WeakRefs::outliveObject));
+
+    std::size_t before = counting_new::liveBytes;
+    auto sp = make_shared_for<SmallType>(WeakRefs::outliveObject);
+    printf("SmallType block: %zu B in one allocation\n", counting_new::liveBytes - before);
+}
+
+// objects without weak_ptrs are destroyed and freed together: nothing to report
+void test_no_weak_refs()
+{
+    using namespace retention;
+
+    setHook(countHook);
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto sp = make_shared_for<SmallType>(WeakRefs::outliveObject);
+        auto big = make_shared_for<ReallyBigType>(WeakRefs::shortLived);
+    }
+    printf("1000 SmallType and ReallyBigType without weak_ptrs: %zu hook calls, %zu B weak-retained\n", hookCalls,
+           retainedBytes());
+    if (hookCalls != 0 || retainedBytes() != 0)
+    {
+        printf("objects without weak_ptrs were reported as weak-retained!\n");
+    }
+    setHook(nullptr);
+}
+
+int main()
+{
+    test_layout_choice();
+    test_no_weak_refs();
+    test_ReallyBigType_retention();
+    return 0;
+}
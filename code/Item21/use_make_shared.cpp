@@ -31,6 +31,8 @@ void test_make_unique()
 void test_allocate_shared()
 {
     auto p = std::allocate_shared<int>(std::allocator<int>(), 42);
+    // pooled_allocate_shared.cpp plugs a pooling allocator in here,
+    // accounting.cpp one that counts control-block and weak-retained bytes
     printf("p=%d\n", *p);
 }
 
@@ -138,6 +140,8 @@ void test_ReallyBigType()
     // by large object remains allocated
     // final std::weak_ptr to object destroyed here;
     // memory for control block and object is released
+
+    // split_lifetime.cpp measures this and picks the layout by size instead
 }
 
 void test_ReallyBigType2()
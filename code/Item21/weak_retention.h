@@ -0,0 +1,199 @@
+#ifndef __WEAK_RETENTION_H__
+#define __WEAK_RETENTION_H__
+
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+// Choosing between make_shared's single allocation and shared_ptr(new T)'s two.
+//
+// With make_shared the object lives inside the control block, so its storage
+// is only released when the last std::weak_ptr goes away, even though the
+// object was destroyed with the last std::shared_ptr. That is cheap for small
+// objects and costly for large ones whose weak_ptrs linger (Item 21's
+// ReallyBigType). make_shared_for picks the layout from sizeof(T) and a hint
+// about the weak references, and RetentionAllocator reports how many bytes are
+// kept alive only by weak references. Objects that no weak_ptr outlives aren't
+// reported at all.
+
+namespace retention
+{
+// called with the change in weak-retained bytes and the new total
+using Hook = void (*)(std::ptrdiff_t delta, std::size_t total);
+
+inline std::atomic<std::size_t> weakRetainedBytes{0};
+inline std::atomic<std::size_t> weakRetainedObjects{0};
+inline std::atomic<Hook> hook{nullptr};
+
+inline void setHook(Hook h) noexcept
+{
+    hook.store(h);
+}
+
+namespace detail
+{
+inline void report(std::ptrdiff_t delta) noexcept
+{
+    std::size_t total = weakRetainedBytes.fetch_add(static_cast<std::size_t>(delta)) + delta;
+    if (Hook h = hook.load(std::memory_order_relaxed))
+    {
+        h(delta, total);
+    }
+}
+
+// The object this thread destroyed last, not yet counted. Without weak_ptrs
+// the library deallocates its block right after destroying it, on the same
+// thread, and the two cancel out unreported; anything else in between means a
+// weak_ptr kept the block. Trivially destructible, so usable until the thread
+// is gone.
+struct Pending
+{
+    const void *object = nullptr;
+    std::size_t bytes = 0;
+    bool threadExited = false;
+};
+
+inline thread_local Pending pending;
+
+inline void commit(Pending &p) noexcept
+{
+    if (p.object != nullptr)
+    {
+        p.object = nullptr;
+        ++weakRetainedObjects;
+        report(static_cast<std::ptrdiff_t>(p.bytes));
+    }
+}
+
+// counts the pending object when the thread exits; later destructions on the
+// thread, by other thread_locals, are counted straight away
+inline void commitAtThreadExit()
+{
+    struct Flush
+    {
+        ~Flush()
+        {
+            commit(pending);
+            pending.threadExited = true;
+        }
+    };
+    thread_local Flush flush;
+    (void)flush;
+}
+} // namespace detail
+
+// weakRetainedBytes, with the last object destroyed on this thread counted
+inline std::size_t retainedBytes() noexcept
+{
+    detail::commit(detail::pending);
+    return weakRetainedBytes.load();
+}
+
+// For allocate_shared<Obj>: the library destroys the object through the
+// allocator when the strong count drops to zero and deallocates the block when
+// the weak count does, so in between sizeof(Obj) bytes are pinned by weak_ptrs.
+// Without outstanding weak_ptrs the two calls follow each other immediately,
+// which the allocator recognizes (see detail::Pending). A retained object is
+// counted at the thread's next destroy or deallocate, retainedBytes() or exit.
+template <typename T, typename Obj = T> class RetentionAllocator
+{
+  public:
+    using value_type = T;
+
+    RetentionAllocator() noexcept = default;
+    template <typename U> RetentionAllocator(const RetentionAllocator<U, Obj> &) noexcept
+    {
+    }
+
+    T *allocate(std::size_t n)
+    {
+        return std::allocator<T>().allocate(n);
+    }
+
+    void deallocate(T *p, std::size_t n) noexcept
+    {
+        if (!std::is_same<T, Obj>::value) // the control block, with the object inside
+        {
+            detail::Pending &q = detail::pending;
+            const char *object = static_cast<const char *>(q.object);
+            const char *block = reinterpret_cast<const char *>(p);
+            std::less<const char *> before;
+            if (object != nullptr && !before(object, block) && before(object, block + n * sizeof(T)))
+            {
+                q.object = nullptr; // destroyed just now: no weak_ptr kept the block
+            }
+            else
+            {
+                detail::commit(q);
+                --weakRetainedObjects;
+                detail::report(-static_cast<std::ptrdiff_t>(sizeof(Obj)));
+            }
+        }
+        std::allocator<T>().deallocate(p, n);
+    }
+
+    template <typename U> void destroy(U *p)
+    {
+        p->~U();
+        if (std::is_same<std::remove_cv_t<U>, Obj>::value)
+        {
+            detail::Pending &q = detail::pending;
+            detail::commit(q);
+            q.object = p;
+            q.bytes = sizeof(Obj);
+            if (q.threadExited)
+            {
+                detail::commit(q);
+            }
+            else
+            {
+                detail::commitAtThreadExit();
+            }
+        }
+    }
+};
+
+template <typename T, typename U, typename Obj>
+bool operator==(const RetentionAllocator<T, Obj> &, const RetentionAllocator<U, Obj> &) noexcept
+{
+    return true;
+}
+template <typename T, typename U, typename Obj>
+bool operator!=(const RetentionAllocator<T, Obj> &, const RetentionAllocator<U, Obj> &) noexcept
+{
+    return false;
+}
+
+enum class WeakRefs
+{
+    shortLived,    // weak_ptrs die with (or soon after) the last shared_ptr
+    outliveObject, // caches, observers: weak_ptrs stay around long after
+};
+
+// objects up to this size are always co-allocated; the wasted bytes are small
+// next to the allocation saved
+constexpr std::size_t coallocateMaxBytes = 1024;
+
+template <typename T> constexpr bool coallocate(WeakRefs weak) noexcept
+{
+    return sizeof(T) <= coallocateMaxBytes || weak == WeakRefs::shortLived;
+}
+
+// make_shared when the object is small or its weak_ptrs are short-lived,
+// otherwise a separate allocation whose storage is freed with the last
+// shared_ptr; only the control block then stays behind for the weak_ptrs
+template <typename T, typename... Ts> std::shared_ptr<T> make_shared_for(WeakRefs weak, Ts &&...params)
+{
+    if (coallocate<T>(weak))
+    {
+        return std::allocate_shared<T>(RetentionAllocator<T>(), std::forward<Ts>(params)...);
+    }
+    return std::shared_ptr<T>(new T(std::forward<Ts>(params)...));
+}
+} // namespace retention
+
+#endif // !__WEAK_RETENTION_H__
@@ -0,0 +1,115 @@
+#include "../Item24/counting_new.h"
+#include "widget.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+// One "request" creates a batch of Widgets, fills and reads them, and throws
+// the batch away. With pimpl_raw_pointer and pimpl_unique_pointer every Widget
+// allocates its Impl and its data separately; pimpl_arena takes all of it from
+// a monotonic arena that lives as long as the request.
+
+constexpr std::size_t batchSize = 1000;
+constexpr int valuesPerWidget = 8;
+
+template <typename Batch> double fillAndRead(Batch &batch)
+{
+    for (auto &w : batch)
+    {
+        for (int v = 0; v < valuesPerWidget; ++v)
+        {
+            w.push(v);
+        }
+    }
+    double total = 0;
+    for (const auto &w : batch)
+    {
+        total += w.sum();
+    }
+    return total;
+}
+
+template <typename Widget> double heapRequest()
+{
+    std::vector<Widget> batch(batchSize);
+    return fillAndRead(batch);
+}
+
+double arenaRequest()
+{
+    std::pmr::monotonic_buffer_resource arena; // grows from the global heap
+    std::pmr::vector<pimpl_arena::Widget> batch(batchSize, &arena);
+    return fillAndRead(batch);
+} // one release for the whole batch
+
+double reusedArenaRequest()
+{
+    static std::vector<std::byte> buffer(1 << 20); // sized for a batch, kept across requests
+    std::pmr::monotonic_buffer_resource arena(buffer.data(), buffer.size());
+    std::pmr::vector<pimpl_arena::Widget> batch(batchSize, &arena);
+    return fillAndRead(batch);
+}
+
+template <typename Request> void measure(const char *name, Request request)
+{
+    constexpr int requests = 300;
+    std::vector<double> latencies;
+    latencies.reserve(requests);
+
+    request(); // warm up
+    auto allocsBefore = counting_new::allocations.load();
+    for (int i = 0; i < requests; ++i)
+    {
+        auto t0 = std::chrono::steady_clock::now();
+        double total = request();
+        auto t1 = std::chrono::steady_clock::now();
+        if (total != batchSize * valuesPerWidget * (valuesPerWidget - 1) / 2)
+        {
+            printf("wrong total!\n");
+        }
+        latencies.push_back(std::chrono::duration<double, std::micro>(t1 - t0).count());
+    }
+    auto allocs = counting_new::allocations - allocsBefore;
+
+    std::sort(latencies.begin(), latencies.end());
+    printf("%-28s %8.1f allocations/request, median %8.1f us, p99 %8.1f us\n", name,
+           static_cast<double>(allocs) / requests, latencies[requests / 2], latencies[requests * 99 / 100]);
+}
+
+// moved-from Widgets can be assigned again, from the same arena or another one
+bool movedFromWidgetsWork()
+{
+    std::pmr::monotonic_buffer_resource arena;
+    pimpl_arena::Widget a(&arena);
+    a.push(1);
+    pimpl_arena::Widget b(std::move(a));
+    pimpl_arena::Widget c; // default resource
+    c.push(2);
+    a = std::move(c); // different resources: copies into a's arena
+    bool ok = a.sum() == 2 && a.get_allocator() == &arena && b.sum() == 1;
+
+    pimpl_arena::Widget d(&arena);
+    pimpl_arena::Widget e(std::move(d));
+    d = b;
+    pimpl_arena::Widget f(std::move(e));
+    e = std::move(d); // same resource: takes d's Impl
+    return ok && e.sum() == 1 && e.get_allocator() == &arena;
+}
+
+int main()
+{
+    if (!movedFromWidgetsWork())
+    {
+        printf("moved-from pimpl_arena::Widget misbehaves!\n");
+    }
+    printf("%zu Widgets per request, %d values each\n", batchSize, valuesPerWidget);
+    measure("pimpl_raw_pointer", heapRequest<pimpl_raw_pointer::Widget>);
+    measure("pimpl_unique_pointer", heapRequest<pimpl_unique_pointer::Widget>);
+    measure("pimpl_arena", arenaRequest);
+    measure("pimpl_arena, reused buffer", reusedArenaRequest);
+    return 0;
+}
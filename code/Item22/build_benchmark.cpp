@@ -0,0 +1,265 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Measures what Item 22 claims: with a pimpl, changing gadget.h only rebuilds
+// widget.cpp, not every client of widget.h.
+//
+// For each header layout the harness writes a small project: gadget.h,
+// widget.h declaring that layout's Widget (as in this directory's widget.h),
+// widget.cpp, and N client translation units that include widget.h. It compiles
+// everything, then edits gadget.h and recompiles only the translation units
+// whose dependency files (-MMD) list it, like make or ninja would. Build times,
+// the number of rebuilt units and object sizes are printed as JSON.
+//
+//     build_benchmark [--tus N] [--gadget-weight K] [--dir PATH] [--out FILE.json]
+//
+// The real gadget.h is trivial; --gadget-weight pulls K heavy standard headers
+// into the generated one to stand in for a real dependency.
+
+namespace fs = std::filesystem;
+
+#ifndef BUILD_BENCH_CXX
+#define BUILD_BENCH_CXX "c++"
+#endif
+#ifndef BUILD_BENCH_ITEM22_DIR
+#define BUILD_BENCH_ITEM22_DIR "."
+#endif
+
+struct Layout
+{
+    const char *name;
+    const char *header; // the class definition clients see
+    const char *impl;   // widget.cpp after the includes
+};
+
+const Layout layouts[] = {
+    {"no_pimpl",
+     "#include \"gadget.h\"\n#include <string>\n#include <vector>\n\n"
+     "class Widget\n{\n  public:\n    Widget();\n\n  private:\n    std::string name;\n"
+     "    std::vector<double> data;\n    Gadget g1, g2, g3;\n};\n",
+     "Widget::Widget() = default;\n"},
+    {"pimpl_raw_pointer",
+     "class Widget\n{\n  public:\n    Widget();\n    ~Widget();\n\n  private:\n    struct Impl;\n"
+     "    Impl *pImpl;\n};\n",
+     "struct Widget::Impl\n{\n    std::string name;\n    std::vector<double> data;\n    Gadget g1, g2, g3;\n};\n\n"
+     "Widget::Widget() : pImpl(new Impl)\n{\n}\n\nWidget::~Widget()\n{\n    delete pImpl;\n}\n"},
+    {"pimpl_unique_pointer",
+     "#include <memory>\n\n"
+     "class Widget\n{\n  public:\n    Widget();\n    ~Widget();\n\n  private:\n    struct Impl;\n"
+     "    std::unique_ptr<Impl> pImpl;\n};\n",
+     "struct Widget::Impl\n{\n    std::string name;\n    std::vector<double> data;\n    Gadget g1, g2, g3;\n};\n\n"
+     "Widget::Widget() : pImpl(std::make_unique<Impl>())\n{\n}\n\nWidget::~Widget() = default;\n"},
+    {"pimpl_shared_pointer",
+     "#include <memory>\n\n"
+     "class Widget\n{\n  public:\n    Widget();\n\n  private:\n    struct Impl;\n"
+     "    std::shared_ptr<Impl> pImpl;\n};\n",
+     "struct Widget::Impl\n{\n    std::string name;\n    std::vector<double> data;\n    Gadget g1, g2, g3;\n};\n\n"
+     "Widget::Widget() : pImpl(std::make_shared<Impl>())\n{\n}\n"},
+    {"pimpl_fast",
+     "#include \"fast_pimpl.h\"\n#include <cstddef>\n\n"
+     "class Widget\n{\n  public:\n    Widget();\n    ~Widget();\n\n  private:\n    struct Impl;\n"
+     "    fast_pimpl<Impl, 64, alignof(std::max_align_t)> pImpl;\n};\n",
+     "struct Widget::Impl\n{\n    std::string name;\n    std::vector<double> data;\n    Gadget g1, g2, g3;\n};\n\n"
+     "Widget::Widget() = default;\nWidget::~Widget() = default;\n"},
+    {"pimpl_cow",
+     "#include \"cow_pimpl.h\"\n\n"
+     "class Widget\n{\n  public:\n    Widget();\n    ~Widget();\n\n  private:\n    struct Impl;\n"
+     "    cow_ptr<Impl> pImpl;\n};\n",
+     "struct Widget::Impl\n{\n    std::string name;\n    std::vector<double> data;\n    Gadget g1, g2, g3;\n};\n\n"
+     "Widget::Widget() = default;\nWidget::~Widget() = default;\n"},
+};
+
+const char *heavyHeaders[] = {"<iostream>", "<regex>", "<map>", "<unordered_map>", "<functional>",
+                              "<algorithm>", "<sstream>", "<chrono>"};
+
+struct Options
+{
+    int tus = 20;
+    int gadgetWeight = 3;
+    fs::path dir = fs::temp_directory_path() / "item22_build_benchmark";
+    std::string out; // stdout if empty
+};
+
+struct Result
+{
+    const char *layout;
+    double fullBuildSeconds = 0;
+    double rebuildSeconds = 0;
+    int rebuiltUnits = 0;
+    std::uintmax_t objectBytes = 0;
+    std::uintmax_t widgetObjectBytes = 0;
+};
+
+void writeFile(const fs::path &path, const std::string &text)
+{
+    std::ofstream(path) << text;
+}
+
+std::string gadgetHeader(int weight, int revision)
+{
+    std::ostringstream os;
+    os << "#ifndef __GADGET_H__\n#define __GADGET_H__\n\n";
+    for (int i = 0; i < weight && i < static_cast<int>(std::size(heavyHeaders)); ++i)
+    {
+        os << "#include " << heavyHeaders[i] << "\n";
+    }
+    os << "\nclass Gadget\n{\n  public:\n    Gadget() = default;\n    ~Gadget() = default;\n";
+    if (revision > 0)
+    {
+        os << "    int revision() const\n    {\n        return " << revision << ";\n    }\n";
+    }
+    os << "};\n\n#endif // !__GADGET_H__\n";
+    return os.str();
+}
+
+// compiles one unit with a dependency file next to the object; returns seconds
+double compile(const fs::path &src)
+{
+    fs::path obj = fs::path(src).replace_extension(".o");
+    fs::path dep = fs::path(src).replace_extension(".d");
+    std::string cmd = std::string(BUILD_BENCH_CXX) + " -std=c++17 -O1 -I\"" + src.parent_path().string() + "\" -I\"" +
+                      BUILD_BENCH_ITEM22_DIR + "\" -MMD -MF \"" + dep.string() + "\" -c \"" + src.string() +
+                      "\" -o \"" + obj.string() + "\"";
+    auto start = std::chrono::steady_clock::now();
+    if (std::system(cmd.c_str()) != 0)
+    {
+        std::fprintf(stderr, "failed: %s\n", cmd.c_str());
+        std::exit(1);
+    }
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+bool dependsOn(const fs::path &src, const std::string &header)
+{
+    std::ifstream in(fs::path(src).replace_extension(".d"));
+    std::string word;
+    while (in >> word)
+    {
+        if (fs::path(word).filename() == header)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+Result run(const Layout &layout, const Options &opt)
+{
+    fs::path dir = opt.dir / layout.name;
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    writeFile(dir / "gadget.h", gadgetHeader(opt.gadgetWeight, 0));
+    writeFile(dir / "widget.h", std::string("#ifndef __WIDGET_H__\n#define __WIDGET_H__\n\n") + layout.header +
+                                    "\n#endif // !__WIDGET_H__\n");
+    writeFile(dir / "widget.cpp", std::string("#include \"widget.h\"\n#include \"gadget.h\"\n#include <memory>\n"
+                                              "#include <string>\n#include <vector>\n\n") +
+                                      layout.impl);
+    std::vector<fs::path> sources{dir / "widget.cpp"};
+    for (int i = 0; i < opt.tus; ++i)
+    {
+        fs::path client = dir / ("client" + std::to_string(i) + ".cpp");
+        writeFile(client, "#include \"widget.h\"\n\nint client" + std::to_string(i) +
+                              "()\n{\n    Widget w;\n    return static_cast<int>(sizeof(w));\n}\n");
+        sources.push_back(client);
+    }
+
+    Result r;
+    r.layout = layout.name;
+    for (const auto &src : sources)
+    {
+        r.fullBuildSeconds += compile(src);
+    }
+    for (const auto &src : sources)
+    {
+        std::uintmax_t size = fs::file_size(fs::path(src).replace_extension(".o"));
+        r.objectBytes += size;
+        if (src.filename() == "widget.cpp")
+        {
+            r.widgetObjectBytes = size;
+        }
+    }
+
+    // the change under test: gadget.h gains a member function
+    writeFile(dir / "gadget.h", gadgetHeader(opt.gadgetWeight, 1));
+    for (const auto &src : sources)
+    {
+        if (dependsOn(src, "gadget.h"))
+        {
+            r.rebuildSeconds += compile(src);
+            ++r.rebuiltUnits;
+        }
+    }
+    return r;
+}
+
+Options parse(int argc, char *argv[])
+{
+    Options opt;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string arg = argv[i];
+        if (arg == "--tus")
+        {
+            opt.tus = std::atoi(argv[i + 1]);
+        }
+        else if (arg == "--gadget-weight")
+        {
+            opt.gadgetWeight = std::atoi(argv[i + 1]);
+        }
+        else if (arg == "--dir")
+        {
+            opt.dir = argv[i + 1];
+        }
+        else if (arg == "--out")
+        {
+            opt.out = argv[i + 1];
+        }
+        else
+        {
+            std::fprintf(stderr, "unknown option %s\n", arg.c_str());
+            std::exit(2);
+        }
+    }
+    return opt;
+}
+
+int main(int argc, char *argv[])
+{
+    Options opt = parse(argc, argv);
+
+    std::ostringstream json;
+    json << "{\n  \"compiler\": \"" << BUILD_BENCH_CXX << "\",\n  \"translation_units\": " << opt.tus
+         << ",\n  \"gadget_weight\": " << opt.gadgetWeight << ",\n  \"layouts\": [\n";
+    bool first = true;
+    for (const Layout &layout : layouts)
+    {
+        std::fprintf(stderr, "building %s...\n", layout.name);
+        Result r = run(layout, opt);
+        json << (first ? "" : ",\n") << "    {\"name\": \"" << r.layout << "\""
+             << ", \"full_build_s\": " << r.fullBuildSeconds
+             << ", \"rebuild_after_gadget_change_s\": " << r.rebuildSeconds
+             << ", \"rebuilt_units\": " << r.rebuiltUnits << ", \"object_bytes\": " << r.objectBytes
+             << ", \"widget_object_bytes\": " << r.widgetObjectBytes << "}";
+        first = false;
+    }
+    json << "\n  ]\n}\n";
+
+    if (opt.out.empty())
+    {
+        std::fputs(json.str().c_str(), stdout);
+    }
+    else
+    {
+        writeFile(opt.out, json.str());
+    }
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include "../Item24/counting_new.h"
+#include "widget.h"
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <random>
+#include <utility>
+#include <vector>
+
+// Copy-heavy work on containers of Widgets: snapshot a container, sort and
+// shuffle the snapshot, then modify a tenth of it. pimpl_unique_pointer copies
+// every Impl up front; pimpl_cow copies only the ones that are modified.
+// (pimpl_shared_pointer is left out: its copies would see each other's changes.)
+
+using Clock = std::chrono::steady_clock;
+
+double msSince(Clock::time_point start)
+{
+    return std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+}
+
+double mib(std::size_t bytes)
+{
+    return bytes / (1024.0 * 1024.0);
+}
+
+template <typename Widget> void workload(const char *name)
+{
+    constexpr std::size_t n = 100000;
+    constexpr int values = 32;
+
+    std::vector<Widget> original(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        for (int v = 0; v < values; ++v)
+        {
+            original[i].push(static_cast<double>((i * 7919 + v) % 1000));
+        }
+    }
+
+    std::size_t bytes0 = counting_new::liveBytes;
+    auto start = Clock::now();
+    std::vector<Widget> snapshot(original);
+    double copyMs = msSince(start);
+    std::size_t copyBytes = counting_new::liveBytes - bytes0;
+
+    // sort by a key computed once per Widget; the moves and reads never clone
+    std::vector<std::pair<double, std::size_t>> keys(n);
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        keys[i] = {snapshot[i].sum(), i};
+    }
+    std::sort(keys.begin(), keys.end());
+    start = Clock::now();
+    std::vector<Widget> sorted;
+    sorted.reserve(n);
+    for (const auto &k : keys)
+    {
+        sorted.push_back(snapshot[k.second]); // one more copy of every Widget
+    }
+    double sortMs = msSince(start);
+
+    start = Clock::now();
+    std::shuffle(sorted.begin(), sorted.end(), std::mt19937(42));
+    double shuffleMs = msSince(start);
+
+    std::size_t bytes1 = counting_new::liveBytes;
+    start = Clock::now();
+    for (std::size_t i = 0; i < n; i += 10)
+    {
+        sorted[i].push(1.0);
+    }
+    double modifyMs = msSince(start);
+    std::size_t modifyBytes = counting_new::liveBytes - bytes1;
+
+    printf("%-16s copy %6.2f ms +%6.2f MiB, sorted copy %6.2f ms, shuffle %6.2f ms, modify 10%% %6.2f ms +%6.2f MiB,"
+           " total %6.2f MiB\n",
+           name, copyMs, mib(copyBytes), sortMs, shuffleMs, modifyMs, mib(modifyBytes),
+           mib(counting_new::liveBytes - bytes0));
+}
+
+// a moved-from Widget reads as a new one and can be written and assigned again
+bool movedFromWidgetsWork()
+{
+    pimpl_cow::Widget a;
+    a.push(1.0);
+    pimpl_cow::Widget b(std::move(a));
+    bool ok = a.sum() == 0 && b.sum() == 1.0;
+    a.push(2.0);
+    ok = ok && a.sum() == 2.0 && b.sum() == 1.0;
+    pimpl_cow::Widget c;
+    c = std::move(a);
+    a = b;
+    ok = ok && a.sum() == 1.0 && c.sum() == 2.0;
+    b = std::move(c);
+    c.push(3.0);
+    return ok && b.sum() == 2.0 && c.sum() == 3.0;
+}
+
+int main()
+{
+    if (!movedFromWidgetsWork())
+    {
+        printf("moved-from pimpl_cow::Widget misbehaves!\n");
+    }
+    workload<pimpl_unique_pointer::Widget>("deep copy");
+    workload<pimpl_cow::Widget>("copy-on-write");
+    return 0;
+}
@@ -0,0 +1,135 @@
+#ifndef __COW_PIMPL_H__
+#define __COW_PIMPL_H__
+
+#include <atomic>
+#include <new>
+#include <utility>
+
+/*
+ * Key Idea:
+ *
+ *   A copy-on-write pimpl. Copies share one Impl and bump a count; the
+ *   first mutating access through write() clones the Impl if it is
+ *   shared. When the count is 1 the owner is the only one who could
+ *   change it, so write() and the destructor skip the atomic
+ *   read-modify-write. Like std::unique_ptr, the members that touch Impl
+ *   are only instantiated where Impl is complete, so the class using
+ *   cow_ptr declares its special member functions in the header and
+ *   defines them in the .cpp. A moved-from cow_ptr owns nothing: it
+ *   reads as a default-constructed Impl, and write() gives it a new
+ *   one, so a moved-from Widget behaves like a new Widget.
+ */
+
+template <typename Impl> class cow_ptr
+{
+  public:
+    cow_ptr() : cow_ptr(std::in_place)
+    {
+    }
+
+    template <typename... Args>
+    explicit cow_ptr(std::in_place_t, Args &&...args) : node(new Node(std::forward<Args>(args)...))
+    {
+    }
+
+    cow_ptr(const cow_ptr &rhs) noexcept : node(rhs.node) // share, don't copy
+    {
+        if (node)
+        {
+            node->refs.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    cow_ptr(cow_ptr &&rhs) noexcept : node(std::exchange(rhs.node, nullptr))
+    {
+    }
+
+    cow_ptr &operator=(const cow_ptr &rhs) noexcept
+    {
+        cow_ptr(rhs).swap(*this);
+        return *this;
+    }
+
+    cow_ptr &operator=(cow_ptr &&rhs) noexcept
+    {
+        cow_ptr(std::move(rhs)).swap(*this);
+        return *this;
+    }
+
+    ~cow_ptr()
+    {
+        release();
+    }
+
+    void swap(cow_ptr &rhs) noexcept
+    {
+        std::swap(node, rhs.node);
+    }
+
+    // reads never clone
+    const Impl &operator*() const
+    {
+        return node ? node->value : empty();
+    }
+    const Impl *operator->() const
+    {
+        return &**this;
+    }
+
+    // the only way to get a mutable Impl: unshares it first
+    Impl &write()
+    {
+        if (node == nullptr) // moved from
+        {
+            node = new Node();
+        }
+        else if (node->refs.load(std::memory_order_acquire) != 1)
+        {
+            Node *clone = new Node(node->value);
+            release();
+            node = clone;
+        }
+        return node->value;
+    }
+
+    long use_count() const noexcept
+    {
+        return node ? node->refs.load(std::memory_order_relaxed) : 0;
+    }
+
+  private:
+    struct Node
+    {
+        template <typename... Args> explicit Node(Args &&...args) : value(std::forward<Args>(args)...)
+        {
+        }
+
+        std::atomic<long> refs{1};
+        Impl value;
+    };
+
+    // what a moved-from cow_ptr reads
+    static const Impl &empty()
+    {
+        static const Impl value{};
+        return value;
+    }
+
+    void release() noexcept
+    {
+        if (node == nullptr)
+        {
+            return;
+        }
+        // sole owner: nobody else can take a reference, so no RMW is needed
+        if (node->refs.load(std::memory_order_acquire) == 1 ||
+            node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            delete node;
+        }
+    }
+
+    Node *node;
+};
+
+#endif // !__COW_PIMPL_H__
@@ -0,0 +1,99 @@
+#ifndef __FAST_PIMPL_H__
+#define __FAST_PIMPL_H__
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+/*
+ * Key Idea:
+ *
+ *   A pimpl whose Impl lives inside the object instead of on the heap.
+ *   The header only reserves Size bytes aligned to Align; Impl stays an
+ *   incomplete type there, so clients still don't recompile when Impl
+ *   changes - unless it outgrows the reservation. Every member below is
+ *   a template that is only instantiated where Impl is complete (the
+ *   special member functions defined in the .cpp), and that is where
+ *   the reservation is checked against sizeof(Impl) and alignof(Impl).
+ */
+
+template <typename Impl, std::size_t Size, std::size_t Align> class fast_pimpl
+{
+  public:
+    fast_pimpl() : fast_pimpl(std::in_place)
+    {
+    }
+
+    template <typename... Args> explicit fast_pimpl(std::in_place_t, Args &&...args)
+    {
+        validate<sizeof(Impl), alignof(Impl)>();
+        ::new (static_cast<void *>(&storage)) Impl(std::forward<Args>(args)...);
+    }
+
+    fast_pimpl(const fast_pimpl &rhs) : fast_pimpl(std::in_place, *rhs)
+    {
+    }
+
+    fast_pimpl(fast_pimpl &&rhs) noexcept(std::is_nothrow_move_constructible<Impl>::value)
+        : fast_pimpl(std::in_place, std::move(*rhs)) // rhs keeps a valid, moved-from Impl
+    {
+    }
+
+    fast_pimpl &operator=(const fast_pimpl &rhs)
+    {
+        **this = *rhs;
+        return *this;
+    }
+
+    fast_pimpl &operator=(fast_pimpl &&rhs) noexcept(std::is_nothrow_move_assignable<Impl>::value)
+    {
+        **this = std::move(*rhs);
+        return *this;
+    }
+
+    ~fast_pimpl()
+    {
+        validate<sizeof(Impl), alignof(Impl)>();
+        get()->~Impl();
+    }
+
+    Impl *operator->() noexcept
+    {
+        return get();
+    }
+    const Impl *operator->() const noexcept
+    {
+        return get();
+    }
+    Impl &operator*() noexcept
+    {
+        return *get();
+    }
+    const Impl &operator*() const noexcept
+    {
+        return *get();
+    }
+
+  private:
+    // the actual size and alignment are template arguments so that they
+    // show up in the compiler's error message
+    template <std::size_t ActualSize, std::size_t ActualAlign> static constexpr void validate() noexcept
+    {
+        static_assert(Size >= ActualSize, "fast_pimpl: Size is too small for Impl, raise it in the header");
+        static_assert(Align % ActualAlign == 0, "fast_pimpl: Align is not a multiple of alignof(Impl)");
+    }
+
+    Impl *get() noexcept
+    {
+        return std::launder(reinterpret_cast<Impl *>(&storage));
+    }
+    const Impl *get() const noexcept
+    {
+        return std::launder(reinterpret_cast<const Impl *>(&storage));
+    }
+
+    alignas(Align) unsigned char storage[Size];
+};
+
+#endif // !__FAST_PIMPL_H__
@@ -0,0 +1,97 @@
+#include "../Item24/counting_new.h"
+#include "widget.h"
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <vector>
+
+// Construction, copy and member access for each way of holding Widget's data.
+// Widget's members are out of line in widget.cpp for every variant, so the
+// differences are the Impl allocation and the extra pointer hop.
+
+using Clock = std::chrono::steady_clock;
+
+double nsPer(Clock::duration d, std::size_t n)
+{
+    return std::chrono::duration<double, std::nano>(d).count() / n;
+}
+
+template <typename Widget> void construct(const char *name, std::size_t n)
+{
+    std::vector<Widget> widgets;
+    widgets.reserve(n);
+    auto allocsBefore = counting_new::allocations.load();
+    auto t0 = Clock::now();
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        widgets.emplace_back();
+    }
+    auto t1 = Clock::now();
+    printf("%-22s sizeof %3zu B, construct %6.1f ns, %.1f allocations/Widget", name, sizeof(Widget), nsPer(t1 - t0, n),
+           static_cast<double>(counting_new::allocations - allocsBefore) / n);
+}
+
+template <typename Widget> void copy(std::size_t n)
+{
+    std::vector<Widget> widgets(n);
+    for (auto &w : widgets)
+    {
+        w.push(1.0);
+    }
+    std::vector<Widget> copies;
+    copies.reserve(n);
+    auto t0 = Clock::now();
+    for (const auto &w : widgets)
+    {
+        copies.push_back(w);
+    }
+    auto t1 = Clock::now();
+    printf(", copy %6.1f ns", nsPer(t1 - t0, n));
+}
+
+template <typename Widget> void access(std::size_t n, int passes)
+{
+    std::vector<Widget> widgets(n);
+    for (auto &w : widgets)
+    {
+        w.push(1.0);
+        w.push(2.0);
+    }
+    double total = 0;
+    auto t0 = Clock::now();
+    for (int p = 0; p < passes; ++p)
+    {
+        for (const auto &w : widgets)
+        {
+            total += w.sum();
+        }
+    }
+    auto t1 = Clock::now();
+    printf(", sum() %5.1f ns%s\n", nsPer(t1 - t0, n * passes), total == 3.0 * n * passes ? "" : " (wrong sum!)");
+}
+
+template <typename Widget> void measure(const char *name, bool copyable = true)
+{
+    constexpr std::size_t n = 200000;
+    construct<Widget>(name, n);
+    if (copyable)
+    {
+        copy<Widget>(n);
+    }
+    else
+    {
+        printf(", copy      n/a");
+    }
+    access<Widget>(n, 20);
+}
+
+int main()
+{
+    measure<no_pimpl::Widget>("no pimpl");
+    measure<pimpl_raw_pointer::Widget>("raw pointer", false); // copying would delete Impl twice
+    measure<pimpl_unique_pointer::Widget>("std::unique_ptr");
+    measure<pimpl_shared_pointer::Widget>("std::shared_ptr"); // copies share Impl
+    measure<pimpl_fast::Widget>("fast_pimpl");
+    measure<pimpl_cow::Widget>("copy-on-write"); // copies share Impl until written
+    return 0;
+}
@@ -1,7 +1,10 @@
 #include "widget.h"
 #include "gadget.h"
 #include <memory>
+#include <memory_resource>
+#include <new>
 #include <string>
+#include <utility>
 #include <vector>
 
 
@@ -18,6 +21,21 @@ namespace no_pimpl
 {
 // commmented to watch the compilation(ld) error
 Widget::Widget() = default;
+
+void Widget::push(double value)
+{
+    data.push_back(value);
+}
+
+double Widget::sum() const
+{
+    double total = 0;
+    for (double d : data)
+    {
+        total += d;
+    }
+    return total;
+}
 } // namespace no_pimpl
 
 namespace pimpl_raw_pointer
@@ -38,6 +56,21 @@ Widget::~Widget()
     delete pImpl;
 }
 
+void Widget::push(double value)
+{
+    pImpl->data.push_back(value);
+}
+
+double Widget::sum() const
+{
+    double total = 0;
+    for (double d : pImpl->data)
+    {
+        total += d;
+    }
+    return total;
+}
+
 } // namespace pimpl_raw_pointer
 
 namespace pimpl_unique_pointer
@@ -69,6 +102,21 @@ Widget &Widget::operator=(const Widget &rhs)
     return *this;
 }
 
+void Widget::push(double value)
+{
+    pImpl->data.push_back(value);
+}
+
+double Widget::sum() const
+{
+    double total = 0;
+    for (double d : pImpl->data)
+    {
+        total += d;
+    }
+    return total;
+}
+
 } // namespace pimpl_unique_pointer
 
 namespace pimpl_shared_pointer
@@ -92,4 +140,200 @@ Widget::Widget()                      // per Item 22 create
     : pImpl(std::make_shared<Impl>()) // std::unique_ptr
 {
 }
-} // namespace pimpl_shared_pointer
\ No newline at end of file
+
+void Widget::push(double value)
+{
+    pImpl->data.push_back(value);
+}
+
+double Widget::sum() const
+{
+    double total = 0;
+    for (double d : pImpl->data)
+    {
+        total += d;
+    }
+    return total;
+}
+} // namespace pimpl_shared_pointer
+
+namespace pimpl_fast
+{
+struct Widget::Impl
+{
+    std::string name;
+    std::vector<double> data;
+    Gadget g1, g2, g3;
+};
+
+Widget::Widget() // constructs Impl in place
+{
+    // fast_pimpl checks this too; here it names the knob to turn
+    static_assert(sizeof(Impl) <= implSize, "Widget::Impl outgrew implSize in widget.h");
+    static_assert(implAlign % alignof(Impl) == 0, "implAlign in widget.h must be a multiple of alignof(Impl)");
+}
+Widget::~Widget() = default;
+
+Widget::Widget(const Widget &rhs) = default;
+Widget &Widget::operator=(const Widget &rhs) = default;
+
+Widget::Widget(Widget &&rhs) = default;
+Widget &Widget::operator=(Widget &&rhs) = default;
+
+void Widget::push(double value)
+{
+    pImpl->data.push_back(value);
+}
+
+double Widget::sum() const
+{
+    double total = 0;
+    for (double d : pImpl->data)
+    {
+        total += d;
+    }
+    return total;
+}
+} // namespace pimpl_fast
+
+namespace pimpl_cow
+{
+struct Widget::Impl
+{
+    std::string name;
+    std::vector<double> data;
+    Gadget g1, g2, g3;
+};
+
+Widget::Widget() = default;
+Widget::~Widget() = default;
+
+Widget::Widget(const Widget &rhs) = default; // shares rhs's Impl
+Widget &Widget::operator=(const Widget &rhs) = default;
+
+Widget::Widget(Widget &&rhs) = default;
+Widget &Widget::operator=(Widget &&rhs) = default;
+
+void Widget::push(double value)
+{
+    pImpl.write().data.push_back(value); // clones Impl if another Widget shares it
+}
+
+double Widget::sum() const
+{
+    double total = 0;
+    for (double d : pImpl->data)
+    {
+        total += d;
+    }
+    return total;
+}
+} // namespace pimpl_cow
+
+namespace pimpl_arena
+{
+struct Widget::Impl
+{
+    explicit Impl(const allocator_type &alloc) : name(alloc), data(alloc)
+    {
+    }
+    Impl(const Impl &rhs, const allocator_type &alloc) : name(rhs.name, alloc), data(rhs.data, alloc)
+    {
+    }
+
+    std::pmr::string name;
+    std::pmr::vector<double> data;
+    Gadget g1, g2, g3;
+};
+
+template <typename... Args> Widget::Impl *Widget::makeImpl(const allocator_type &alloc, Args &&...args)
+{
+    std::pmr::memory_resource *r = alloc.resource();
+    void *p = r->allocate(sizeof(Impl), alignof(Impl));
+    try
+    {
+        return ::new (p) Impl(std::forward<Args>(args)..., alloc);
+    }
+    catch (...)
+    {
+        r->deallocate(p, sizeof(Impl), alignof(Impl));
+        throw;
+    }
+}
+
+Widget::Widget() : Widget(allocator_type())
+{
+}
+
+Widget::Widget(const allocator_type &alloc) : alloc(alloc), pImpl(makeImpl(alloc))
+{
+}
+
+Widget::~Widget()
+{
+    if (pImpl)
+    {
+        pImpl->~Impl(); // with a monotonic resource these deallocations are no-ops
+        alloc.resource()->deallocate(pImpl, sizeof(Impl), alignof(Impl));
+    }
+}
+
+Widget::Widget(const Widget &rhs) : Widget(rhs, allocator_type()) // like std::pmr containers
+{
+}
+
+Widget::Widget(const Widget &rhs, const allocator_type &alloc) : alloc(alloc), pImpl(makeImpl(alloc, *rhs.pImpl))
+{
+}
+
+Widget &Widget::operator=(const Widget &rhs)
+{
+    if (pImpl == nullptr) // moved from: nothing to assign through
+    {
+        pImpl = makeImpl(alloc, *rhs.pImpl);
+    }
+    else
+    {
+        pImpl->name = rhs.pImpl->name;
+        pImpl->data = rhs.pImpl->data;
+    }
+    return *this;
+}
+
+Widget::Widget(Widget &&rhs) noexcept : alloc(rhs.alloc), pImpl(std::exchange(rhs.pImpl, nullptr))
+{
+}
+
+Widget::Widget(Widget &&rhs, const allocator_type &alloc)
+    : alloc(alloc), pImpl(alloc == rhs.alloc ? std::exchange(rhs.pImpl, nullptr) : makeImpl(alloc, *rhs.pImpl))
+{
+}
+
+Widget &Widget::operator=(Widget &&rhs)
+{
+    if (alloc == rhs.alloc)
+    {
+        std::swap(pImpl, rhs.pImpl);
+    }
+    else
+    {
+        *this = rhs; // different arenas: the Impl can't change hands
+    }
+    return *this;
+}
+
+void Widget::push(double value)
+{
+    pImpl->data.push_back(value);
+}
+
+double Widget::sum() const
+{
+    double total = 0;
+    for (double d : pImpl->data)
+    {
+        total += d;
+    }
+    return total;
+}
+} // namespace pimpl_arena
\ No newline at end of file
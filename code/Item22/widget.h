@@ -1,8 +1,12 @@
 #ifndef __WIDGET_H__
 #define __WIDGET_H__
 
+#include "cow_pimpl.h"
+#include "fast_pimpl.h"
 #include "gadget.h"
+#include <cstddef>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <vector>
 
@@ -14,6 +18,9 @@ class Widget
   public:
     Widget();
 
+    void push(double value);
+    double sum() const;
+
   private:
     std::string name;
     std::vector<double> data;
@@ -40,6 +47,9 @@ class Widget
     Widget();
     ~Widget(); // dtor is needed - see below
 
+    void push(double value);
+    double sum() const;
+
   private:
     struct Impl; // declare implementation struct
     Impl *pImpl; // and pointer to it
@@ -65,6 +75,9 @@ class Widget
     Widget(Widget &&rhs);
     Widget &operator=(Widget &&rhs);
 
+    void push(double value);
+    double sum() const;
+
   private:
     struct Impl;
     std::unique_ptr<Impl> pImpl; // use smart pointer instead of raw pointer
@@ -87,10 +100,127 @@ class Widget
     // no declarations for dtor
     // or move operations
 
+    void push(double value);
+    double sum() const;
+
   private:
     struct Impl;
     std::shared_ptr<Impl> pImpl; // std::shared_ptr
 };
 } // namespace pimpl_shared_pointer
 
+namespace pimpl_fast
+{
+/*
+ * Key Idea:
+ *
+ *   Same firewall as pimpl_unique_pointer, but Impl is stored inside
+ *   the Widget: no allocation per Widget and no pointer to chase.
+ *   The price is a size guess here, checked in widget.cpp. As with
+ *   std::unique_ptr, the special member functions must be declared
+ *   here and defined where Impl is complete.
+ */
+class Widget
+{
+  public:
+    Widget();
+    ~Widget();
+
+    Widget(const Widget &rhs);
+    Widget &operator=(const Widget &rhs);
+
+    Widget(Widget &&rhs);
+    Widget &operator=(Widget &&rhs);
+
+    void push(double value);
+    double sum() const;
+
+  private:
+    struct Impl;
+    static constexpr std::size_t implSize = 64;
+    static constexpr std::size_t implAlign = alignof(std::max_align_t);
+    fast_pimpl<Impl, implSize, implAlign> pImpl; // room for Impl, not a pointer to it
+};
+} // namespace pimpl_fast
+
+namespace pimpl_cow
+{
+/*
+ * Key Idea:
+ *
+ *   Copies share Impl, unlike pimpl_unique_pointer's deep copy, but
+ *   keep value semantics, unlike pimpl_shared_pointer: a Widget that
+ *   is about to change gets its own Impl first. Copying is a count
+ *   increment, and only Widgets that are actually modified pay for
+ *   the copy of data.
+ */
+class Widget
+{
+  public:
+    Widget();
+    ~Widget();
+
+    Widget(const Widget &rhs);
+    Widget &operator=(const Widget &rhs);
+
+    Widget(Widget &&rhs);
+    Widget &operator=(Widget &&rhs);
+
+    void push(double value);
+    double sum() const;
+
+  private:
+    struct Impl;
+    cow_ptr<Impl> pImpl;
+};
+} // namespace pimpl_cow
+
+namespace pimpl_arena
+{
+/*
+ * Key Idea:
+ *
+ *   The Impl, and the string and vector inside it, come from a
+ *   std::pmr::memory_resource. Give a batch of Widgets one
+ *   std::pmr::monotonic_buffer_resource and every allocation for the
+ *   batch is a pointer bump; tearing the batch down frees nothing
+ *   piecemeal, the resource releases it all at once. Widget is
+ *   allocator-aware, so a std::pmr::vector<Widget> hands its resource
+ *   on to the Widgets it constructs.
+ */
+class Widget
+{
+  public:
+    using allocator_type = std::pmr::polymorphic_allocator<std::byte>;
+
+    Widget();
+    explicit Widget(const allocator_type &alloc);
+    ~Widget();
+
+    Widget(const Widget &rhs);
+    Widget(const Widget &rhs, const allocator_type &alloc);
+    Widget &operator=(const Widget &rhs);
+
+    // a moved-from Widget can only be assigned to or destroyed
+    Widget(Widget &&rhs) noexcept;
+    Widget(Widget &&rhs, const allocator_type &alloc);
+    Widget &operator=(Widget &&rhs);
+
+    allocator_type get_allocator() const noexcept
+    {
+        return alloc;
+    }
+
+    void push(double value);
+    double sum() const;
+
+  private:
+    struct Impl;
+    template <typename... Args> static Impl *makeImpl(const allocator_type &alloc, Args &&...args);
+
+    allocator_type alloc;
+    Impl *pImpl; // allocated from alloc.resource()
+};
+} // namespace pimpl_arena
+
 #endif // ! __WIDGET_H__
\ No newline at end of file
@@ -0,0 +1,441 @@
+#ifndef __INSTRUMENTED_H__
+#define __INSTRUMENTED_H__
+
+#include "../Item24/counting_new_counters.h"
+#include <boost/type_index.hpp>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// Counting copies and moves, for any type, in any item's demo.
+//
+// count_move::Widget in move_and_forward.cpp keeps a static moveCtorCalls; this
+// generalizes it. Every special member function of a counted type bumps a
+// per-type, per-thread counter, so counting costs no contention. counts<T>()
+// adds up all threads and report() prints every type seen so far.
+// • Instrumented<T> wraps a value: Instrumented<std::string> behaves like the
+// string it holds (get(), ->, conversion) and counts what happens to it.
+// • Counted<Derived> is a base class for types of your own: the
+// compiler-generated special members call it; hand-written ones must pass rhs
+// on (Counted<Derived>(std::move(rhs))) or they count as constructions.
+// • Heap bytes are what the constructors and assignments of Instrumented<T>
+// request from operator new, e.g. a std::string copy's buffer. They come from
+// the per-thread counter of Item24/counting_new.h, so they stay 0 unless the
+// program includes that header. Counted<Derived> can't see Derived's members
+// being built and counts none.
+// • Counting never throws and works from the first to the last destructor of
+// a program, including those of statics and thread_locals.
+
+namespace instrumented
+{
+enum Event : std::size_t
+{
+    constructions, // any constructor other than copy and move
+    copies,
+    moves,
+    copyAssignments,
+    moveAssignments,
+    destructions,
+    heapBytes, // a sum, not a count
+    eventCount
+};
+
+struct Counts
+{
+    std::uint64_t value[eventCount] = {};
+
+    std::uint64_t operator[](Event e) const noexcept
+    {
+        return value[e];
+    }
+
+    friend Counts operator-(Counts a, const Counts &b) noexcept
+    {
+        for (std::size_t e = 0; e < eventCount; ++e)
+        {
+            a.value[e] -= b.value[e];
+        }
+        return a;
+    }
+};
+
+namespace detail
+{
+// written only by its thread, read by anyone: plain loads and stores, no RMW
+struct ThreadSlot
+{
+    std::atomic<std::uint64_t> value[eventCount] = {};
+
+    void add(Event e, std::uint64_t n) noexcept
+    {
+        value[e].store(value[e].load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+    }
+};
+
+class TypeStats
+{
+  public:
+    explicit TypeStats(boost::typeindex::type_index type) noexcept : type(type)
+    {
+    }
+
+    std::string name() const
+    {
+        return type.pretty_name();
+    }
+
+    // a slot for the calling thread: one an exited thread left, or a new one
+    ThreadSlot *attach()
+    {
+        std::lock_guard<std::mutex> guard{m};
+        if (!idle.empty())
+        {
+            ThreadSlot *slot = idle.back();
+            idle.pop_back();
+            return slot;
+        }
+        idle.reserve(slots.size() + 1); // so that detach() doesn't allocate
+        slots.push_back(std::make_unique<ThreadSlot>());
+        return slots.back().get();
+    }
+
+    // a thread is exiting: its slot, counts and all, waits for the next thread
+    void detach(ThreadSlot *slot) noexcept
+    {
+        std::lock_guard<std::mutex> guard{m};
+        idle.push_back(slot);
+    }
+
+    // for events of a thread without a slot: one that has exited, or ran out
+    // of memory for the slot
+    void addShared(Event e, std::uint64_t n) noexcept
+    {
+        shared[e].fetch_add(n, std::memory_order_relaxed);
+    }
+
+    Counts total() const
+    {
+        Counts c;
+        for (std::size_t e = 0; e < eventCount; ++e)
+        {
+            c.value[e] = shared[e].load(std::memory_order_relaxed);
+        }
+        std::lock_guard<std::mutex> guard{m};
+        for (const auto &slot : slots)
+        {
+            for (std::size_t e = 0; e < eventCount; ++e)
+            {
+                c.value[e] += slot->value[e].load(std::memory_order_relaxed);
+            }
+        }
+        return c - baseline;
+    }
+
+    // other threads' slots are never written, so a reset moves the baseline
+    void reset()
+    {
+        Counts now = total();
+        std::lock_guard<std::mutex> guard{m};
+        for (std::size_t e = 0; e < eventCount; ++e)
+        {
+            baseline.value[e] += now.value[e];
+        }
+    }
+
+    TypeStats *next = nullptr; // in the list of all types
+
+  private:
+    const boost::typeindex::type_index type;
+    mutable std::mutex m;
+    std::vector<std::unique_ptr<ThreadSlot>> slots; // never freed: a late destructor may still count
+    std::vector<ThreadSlot *> idle;
+    std::atomic<std::uint64_t> shared[eventCount] = {};
+    Counts baseline;
+};
+
+// every type counted so far, newest first
+inline std::atomic<TypeStats *> types{nullptr};
+
+template <typename T> TypeStats &stats() noexcept
+{
+    // built in place without allocating and never destroyed, so it outlives
+    // every thread and every static that still counts in its destructor
+    alignas(TypeStats) static unsigned char storage[sizeof(TypeStats)];
+    static TypeStats *s = [] {
+        auto *p = ::new (static_cast<void *>(storage)) TypeStats(boost::typeindex::type_id<T>());
+        p->next = types.load(std::memory_order_relaxed);
+        while (!types.compare_exchange_weak(p->next, p, std::memory_order_release, std::memory_order_relaxed))
+        {
+        }
+        return p;
+    }();
+    return *s;
+}
+
+// true for a single argument of type Self, however qualified
+template <typename Self, typename... Args> struct IsSelf : std::false_type
+{
+};
+
+template <typename Self, typename Arg> struct IsSelf<Self, Arg> : std::is_same<Self, std::decay_t<Arg>>
+{
+};
+
+// the calling thread's slot for T. Trivially destructible, so it can still be
+// read by the destructors that run after ThreadExit<T>'s.
+struct Binding
+{
+    ThreadSlot *slot = nullptr;
+    bool threadExited = false;
+};
+
+template <typename T> Binding &binding() noexcept
+{
+    thread_local Binding b;
+    return b;
+}
+
+// hands the slot back when the thread exits
+template <typename T> struct ThreadExit
+{
+    ~ThreadExit()
+    {
+        Binding &b = binding<T>();
+        stats<T>().detach(b.slot);
+        b.slot = nullptr;
+        b.threadExited = true;
+    }
+};
+
+// the thread's first event for T: the one that allocates, kept out of record()
+template <typename T> void bind(Binding &b)
+{
+    b.slot = stats<T>().attach();
+    thread_local ThreadExit<T> exit;
+    (void)exit;
+}
+
+template <typename T> void record(Event e, std::uint64_t n = 1) noexcept
+{
+    Binding &b = binding<T>();
+    if (b.slot == nullptr && !b.threadExited)
+    {
+        try
+        {
+            bind<T>(b);
+        }
+        catch (...) // no memory for a slot: count through the shared counters
+        {
+        }
+    }
+    if (b.slot != nullptr)
+    {
+        b.slot->add(e, n);
+    }
+    else
+    {
+        stats<T>().addShared(e, n);
+    }
+}
+
+// the calling thread's heap requests from here on
+class HeapMark
+{
+  public:
+    std::uint64_t bytes() const noexcept
+    {
+        return counting_new::threadRequestedBytes - start;
+    }
+
+  private:
+    std::size_t start = counting_new::threadRequestedBytes;
+};
+} // namespace detail
+
+// what has happened to objects of type T, over all threads, since the last reset
+template <typename T> Counts counts()
+{
+    return detail::stats<T>().total();
+}
+
+template <typename T> void reset()
+{
+    detail::stats<T>().reset();
+}
+
+inline void resetAll()
+{
+    for (detail::TypeStats *s = detail::types.load(std::memory_order_acquire); s != nullptr; s = s->next)
+    {
+        s->reset();
+    }
+}
+
+inline void printHeader(std::FILE *out = stdout)
+{
+    std::fprintf(out, "%-40s %8s %8s %8s %8s %8s %8s %10s\n", "type", "ctors", "copies", "moves", "copy=", "move=",
+                 "dtors", "heap B");
+}
+
+inline void print(const char *name, const Counts &c, std::FILE *out = stdout)
+{
+    std::fprintf(out, "%-40s %8llu %8llu %8llu %8llu %8llu %8llu %10llu\n", name,
+                 static_cast<unsigned long long>(c[constructions]), static_cast<unsigned long long>(c[copies]),
+                 static_cast<unsigned long long>(c[moves]), static_cast<unsigned long long>(c[copyAssignments]),
+                 static_cast<unsigned long long>(c[moveAssignments]), static_cast<unsigned long long>(c[destructions]),
+                 static_cast<unsigned long long>(c[heapBytes]));
+}
+
+// one line per counted type, in the order they were first counted
+inline void report(std::FILE *out = stdout)
+{
+    std::vector<detail::TypeStats *> all;
+    for (detail::TypeStats *s = detail::types.load(std::memory_order_acquire); s != nullptr; s = s->next)
+    {
+        all.push_back(s);
+    }
+    printHeader(out);
+    for (auto it = all.rbegin(); it != all.rend(); ++it)
+    {
+        print((*it)->name().c_str(), (*it)->total(), out);
+    }
+}
+
+// base class that counts the special member calls of Derived
+template <typename Derived> class Counted
+{
+  public:
+    Counted() noexcept
+    {
+        detail::record<Derived>(constructions);
+    }
+    Counted(const Counted &) noexcept
+    {
+        detail::record<Derived>(copies);
+    }
+    Counted(Counted &&) noexcept
+    {
+        detail::record<Derived>(moves);
+    }
+    Counted &operator=(const Counted &) noexcept
+    {
+        detail::record<Derived>(copyAssignments);
+        return *this;
+    }
+    Counted &operator=(Counted &&) noexcept
+    {
+        detail::record<Derived>(moveAssignments);
+        return *this;
+    }
+    ~Counted()
+    {
+        detail::record<Derived>(destructions);
+    }
+};
+
+// a T that counts under the name of T
+template <typename T> class Instrumented
+{
+  public:
+    // constrained so that it doesn't hijack copying a non-const Instrumented (Item 26)
+    template <typename... Args, typename = std::enable_if_t<!detail::IsSelf<Instrumented, Args...>::value &&
+                                                            std::is_constructible<T, Args &&...>::value>>
+    Instrumented(Args &&...args) : Instrumented(detail::HeapMark(), constructions, std::forward<Args>(args)...)
+    {
+    }
+
+    Instrumented(const Instrumented &rhs) : Instrumented(detail::HeapMark(), copies, rhs.value)
+    {
+    }
+    Instrumented(Instrumented &&rhs) noexcept(std::is_nothrow_move_constructible<T>::value)
+        : Instrumented(detail::HeapMark(), moves, std::move(rhs.value))
+    {
+    }
+    Instrumented &operator=(const Instrumented &rhs)
+    {
+        detail::HeapMark mark;
+        value = rhs.value;
+        record(copyAssignments, mark);
+        return *this;
+    }
+    Instrumented &operator=(Instrumented &&rhs) noexcept(std::is_nothrow_move_assignable<T>::value)
+    {
+        detail::HeapMark mark;
+        value = std::move(rhs.value);
+        record(moveAssignments, mark);
+        return *this;
+    }
+    ~Instrumented()
+    {
+        detail::record<T>(destructions);
+    }
+
+    T &get() & noexcept
+    {
+        return value;
+    }
+    const T &get() const & noexcept
+    {
+        return value;
+    }
+    T &&get() && noexcept
+    {
+        return std::move(value);
+    }
+    T *operator->() noexcept
+    {
+        return &value;
+    }
+    const T *operator->() const noexcept
+    {
+        return &value;
+    }
+    operator const T &() const noexcept
+    {
+        return value;
+    }
+
+    friend bool operator==(const Instrumented &a, const Instrumented &b)
+    {
+        return a.value == b.value;
+    }
+    friend bool operator!=(const Instrumented &a, const Instrumented &b)
+    {
+        return !(a == b);
+    }
+    friend bool operator<(const Instrumented &a, const Instrumented &b)
+    {
+        return a.value < b.value;
+    }
+
+  private:
+    // the mark is taken before value is built, as the argument of this constructor
+    template <typename... Args>
+    Instrumented(detail::HeapMark mark, Event e, Args &&...args) : value(std::forward<Args>(args)...)
+    {
+        record(e, mark);
+    }
+
+    static void record(Event e, const detail::HeapMark &mark) noexcept
+    {
+        std::uint64_t bytes = mark.bytes(); // before record() can allocate
+        detail::record<T>(e);
+        if (bytes != 0)
+        {
+            detail::record<T>(heapBytes, bytes);
+        }
+    }
+
+    T value;
+};
+} // namespace instrumented
+
+#endif // !__INSTRUMENTED_H__
@@ -1,5 +1,8 @@
+#include "../Item24/counting_new.h"
+#include "instrumented.h"
 #include <boost/type_index.hpp>
 #include <cstdio>
+#include <string>
 #include <type_traits>
 
 // • std::move performs an unconditional cast to an rvalue. In and of itself, it
@@ -50,6 +53,9 @@ void test_move()
            boost::typeindex::type_id_with_cvr<decltype(experimetal_14::move(w))>().pretty_name().c_str());
 }
 
+// counts its copies and moves, see instrumented.h
+using Text = instrumented::Instrumented<std::string>;
+
 class Annotation
 {
   public:
@@ -57,19 +63,25 @@ class Annotation
     //                                         // so per Item 41,
     //                                         // pass by value
 
-    explicit Annotation(const std::string text) : value(std::move(text)) // "move" text into value; this code
-    {                                                                    /* ... */
+    explicit Annotation(const Text text) : value(std::move(text)) // "move" text into value; this code
+    {                                                             /* ... */
     } // doesn't do what it seems to!
 
   private:
-    std::string value;
+    Text value;
 };
 
 void test_annotation()
 {
-    std::string text = "hello";
+    Text text = "hello, and long enough not to fit in the string object"; // so that copies allocate
+    instrumented::reset<std::string>();
     Annotation a(text); // copy construction of std::string
-    // printf("text is %s\n", text.c_str());
+    // printf("text is %s\n", text->c_str());
+    auto c = instrumented::counts<std::string>();
+    printf("Annotation: %llu copies, %llu moves, %llu heap B\n", // 2 copies: into text, and into value
+           static_cast<unsigned long long>(c[instrumented::copies]),
+           static_cast<unsigned long long>(c[instrumented::moves]),
+           static_cast<unsigned long long>(c[instrumented::heapBytes]));
 }
 
 // typical use of std::forward
@@ -110,7 +122,7 @@ class Widget
 
   private:
     static std::size_t moveCtorCalls;
-    std::string s;
+    Text s;
 };
 std::size_t Widget::moveCtorCalls = 0;
 } // namespace count_move
@@ -123,15 +135,15 @@ class Widget
     Widget() : s("hello")
     {
     }
-    Widget(Widget &&rhs)                      // unconventional,
-        : s(std::forward<std::string>(rhs.s)) // undesirable
+    Widget(Widget &&rhs)               // unconventional,
+        : s(std::forward<Text>(rhs.s)) // undesirable
     {
         ++moveCtorCalls;
     } // implementation
 
   private:
     static std::size_t moveCtorCalls;
-    std::string s;
+    Text s;
 };
 std::size_t Widget::moveCtorCalls = 0;
 
@@ -139,11 +151,27 @@ std::size_t Widget::moveCtorCalls = 0;
 
 void test_count()
 {
-    count_move::Widget w1;
-    count_move::Widget w2(std::move(w1));
+    using instrumented::copies;
+    using instrumented::moves;
+
+    instrumented::reset<std::string>();
+    {
+        count_move::Widget w1;
+        count_move::Widget w2(std::move(w1));
+    }
+    auto c = instrumented::counts<std::string>();
+    printf("std::move:    %llu copies, %llu moves\n", static_cast<unsigned long long>(c[copies]),
+           static_cast<unsigned long long>(c[moves]));
 
-    count_forward::Widget w3;
-    count_forward::Widget w4(std::move(w3));
+    instrumented::reset<std::string>();
+    {
+        count_forward::Widget w3;
+        count_forward::Widget w4(std::move(w3));
+    }
+    c = instrumented::counts<std::string>();
+    printf("std::forward: %llu copies, %llu moves\n", static_cast<unsigned long long>(c[copies]),
+           static_cast<unsigned long long>(c[moves])); // same as std::move, just noisier
+    instrumented::report(); // the std::forward block: 1 construction, 1 move, 2 destructions
 }
 
 int main()
@@ -153,6 +181,7 @@ int main()
     test_move();
     test_annotation();
     test_logAndProcess();
+    test_count();
 
     return 0;
 }
\ No newline at end of file
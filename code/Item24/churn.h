@@ -0,0 +1,47 @@
+#ifndef __CHURN_H__
+#define __CHURN_H__
+
+#include <chrono>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+// The allocation churn the pool and allocator benchmarks share: every thread
+// creates a batch of objects with create(i), i = 0 ... batch - 1, keeps them
+// alive together, then drops the whole batch, rounds times over.
+
+namespace timing
+{
+// millions of create+destroy per second over all threads
+template <typename CreateFunc> double churn(unsigned threads, std::size_t rounds, CreateFunc create)
+{
+    constexpr std::size_t batch = 64;
+
+    auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> workers;
+    for (unsigned t = 0; t < threads; ++t)
+    {
+        workers.emplace_back([&] {
+            std::vector<decltype(create(std::size_t(0)))> live;
+            live.reserve(batch);
+            for (std::size_t r = 0; r < rounds; ++r)
+            {
+                for (std::size_t i = 0; i < batch; ++i)
+                {
+                    live.push_back(create(i));
+                }
+                live.clear();
+            }
+        });
+    }
+    for (auto &w : workers)
+    {
+        w.join();
+    }
+    auto end = std::chrono::steady_clock::now();
+    double seconds = std::chrono::duration<double>(end - start).count();
+    return threads * rounds * batch / seconds / 1e6;
+}
+} // namespace timing
+
+#endif // !__CHURN_H__
@@ -0,0 +1,97 @@
+#ifndef __COUNTING_NEW_H__
+#define __COUNTING_NEW_H__
+
+#include "counting_new_counters.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+// Replacement global operator new/delete that count what the program takes
+// from the heap, for the benchmarks that report allocations or bytes.
+// • allocations: calls to operator new, including the aligned forms.
+// • requestedBytes: bytes asked for, ever.
+// • liveBytes: bytes asked for and not yet given back. Every block keeps its
+// size in a header in front of it so operator delete can subtract it.
+// • threadRequestedBytes: requestedBytes of the calling thread alone, so that
+// the difference between two readings is what the code in between asked for.
+// The array and nothrow forms go through these by default, so they are counted
+// too. Replacement functions can't be inline: include this header from exactly
+// one source file of a program, the one with main.
+
+namespace counting_new
+{
+namespace detail
+{
+constexpr std::size_t header = alignof(std::max_align_t);
+
+// block points at the start of an allocation of at least offset + size bytes
+inline void *track(void *block, std::size_t offset, std::size_t size) noexcept
+{
+    void *p = static_cast<char *>(block) + offset;
+    static_cast<std::size_t *>(p)[-1] = size;
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    requestedBytes.fetch_add(size, std::memory_order_relaxed);
+    threadRequestedBytes += size;
+    liveBytes.fetch_add(size, std::memory_order_relaxed);
+    return p;
+}
+
+// returns the start of p's block
+inline void *untrack(void *p, std::size_t offset) noexcept
+{
+    liveBytes.fetch_sub(static_cast<std::size_t *>(p)[-1], std::memory_order_relaxed);
+    return static_cast<char *>(p) - offset;
+}
+} // namespace detail
+} // namespace counting_new
+
+void *operator new(std::size_t size)
+{
+    if (void *block = std::malloc(counting_new::detail::header + size))
+    {
+        return counting_new::detail::track(block, counting_new::detail::header, size);
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept
+{
+    if (p)
+    {
+        std::free(counting_new::detail::untrack(p, counting_new::detail::header));
+    }
+}
+
+void operator delete(void *p, std::size_t) noexcept
+{
+    ::operator delete(p);
+}
+
+// std::pmr::new_delete_resource() allocates through the aligned forms; the
+// header is a whole alignment unit so the object stays aligned
+void *operator new(std::size_t size, std::align_val_t align)
+{
+    std::size_t a = std::max(static_cast<std::size_t>(align), counting_new::detail::header);
+    if (void *block = std::aligned_alloc(a, (a + size + a - 1) / a * a))
+    {
+        return counting_new::detail::track(block, a, size);
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p, std::align_val_t align) noexcept
+{
+    if (p)
+    {
+        std::size_t a = std::max(static_cast<std::size_t>(align), counting_new::detail::header);
+        std::free(counting_new::detail::untrack(p, a));
+    }
+}
+
+void operator delete(void *p, std::size_t, std::align_val_t align) noexcept
+{
+    ::operator delete(p, align);
+}
+
+#endif // !__COUNTING_NEW_H__
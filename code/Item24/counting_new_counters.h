@@ -0,0 +1,19 @@
+#ifndef __COUNTING_NEW_COUNTERS_H__
+#define __COUNTING_NEW_COUNTERS_H__
+
+#include <atomic>
+#include <cstddef>
+
+// The counters of counting_new.h, for code that reads them without replacing
+// operator new itself: headers, and the other source files of a program. They
+// stay 0 unless the program includes counting_new.h.
+
+namespace counting_new
+{
+inline std::atomic<std::size_t> allocations{0};
+inline std::atomic<std::size_t> requestedBytes{0};
+inline std::atomic<std::size_t> liveBytes{0};
+inline thread_local std::size_t threadRequestedBytes = 0;
+} // namespace counting_new
+
+#endif // !__COUNTING_NEW_COUNTERS_H__
@@ -0,0 +1,188 @@
+#ifndef __PERF_COUNTERS_H__
+#define __PERF_COUNTERS_H__
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+
+#if defined(__linux__)
+#include <cerrno>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+// Hardware and software event counters through Linux perf_event_open, for the
+// timing harness in timing.h.
+// • Each event is opened on its own, so a machine that lacks one (say, LLC
+// misses in a VM) still reports the rest.
+// • When none can be opened - no Linux, perf_event_paranoid too strict, a
+// container without CAP_PERFMON - available() is false, why() says why, and the
+// harness just leaves the columns out.
+// • Counts are scaled by time_enabled/time_running, in case the kernel had to
+// multiplex the hardware counters.
+
+namespace timing
+{
+// the order of the arrays in CounterValues and PerfCounters
+enum class Counter : std::size_t
+{
+    cycles,
+    instructions,
+    l1dMisses,
+    llcMisses,
+    branchMisses,
+    contextSwitches,
+    count
+};
+
+constexpr std::size_t counterCount = static_cast<std::size_t>(Counter::count);
+
+inline const char *counterName(Counter c)
+{
+    static const char *const names[counterCount] = {"cycles",     "instructions",  "L1d_misses",
+                                                    "LLC_misses", "branch_misses", "context_switches"};
+    return names[static_cast<std::size_t>(c)];
+}
+
+struct CounterValues
+{
+    bool valid[counterCount] = {};
+    double value[counterCount] = {};
+};
+
+class PerfCounters
+{
+  public:
+    PerfCounters()
+    {
+#if defined(__linux__)
+        constexpr std::uint64_t l1dReadMiss = PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                                              (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const std::uint32_t types[counterCount] = {PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE,
+                                                   PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE};
+        const std::uint64_t configs[counterCount] = {PERF_COUNT_HW_CPU_CYCLES,    PERF_COUNT_HW_INSTRUCTIONS,
+                                                     l1dReadMiss,                 PERF_COUNT_HW_CACHE_MISSES,
+                                                     PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_CONTEXT_SWITCHES};
+        int lastErrno = 0;
+        for (std::size_t c = 0; c < counterCount; ++c)
+        {
+            fds[c] = open(types[c], configs[c], types[c] != PERF_TYPE_SOFTWARE);
+            if (fds[c] < 0 && types[c] == PERF_TYPE_SOFTWARE) // kernel side not allowed: count user side only
+            {
+                fds[c] = open(types[c], configs[c], true);
+            }
+            if (fds[c] >= 0)
+            {
+                anyOpen = true;
+            }
+            else
+            {
+                lastErrno = errno;
+            }
+        }
+        if (!anyOpen)
+        {
+            reason = std::string("perf_event_open failed: ") + std::strerror(lastErrno) +
+                     (lastErrno == EACCES || lastErrno == EPERM
+                          ? " (check /proc/sys/kernel/perf_event_paranoid or container permissions)"
+                          : "");
+        }
+#else
+        reason = "hardware counters are only supported on Linux";
+#endif
+    }
+
+    ~PerfCounters()
+    {
+#if defined(__linux__)
+        for (int fd : fds)
+        {
+            if (fd >= 0)
+            {
+                close(fd);
+            }
+        }
+#endif
+    }
+
+    PerfCounters(const PerfCounters &) = delete;
+    PerfCounters &operator=(const PerfCounters &) = delete;
+
+    bool available() const noexcept
+    {
+        return anyOpen;
+    }
+
+    const std::string &why() const noexcept
+    {
+        return reason;
+    }
+
+    void start() noexcept
+    {
+#if defined(__linux__)
+        for (int fd : fds)
+        {
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+            }
+        }
+#endif
+    }
+
+    // stops counting; the counts since start(), divided by calls
+    CounterValues stop(double calls = 1) noexcept
+    {
+        CounterValues v;
+#if defined(__linux__)
+        for (int fd : fds)
+        {
+            if (fd >= 0)
+            {
+                ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+            }
+        }
+        for (std::size_t c = 0; c < counterCount; ++c)
+        {
+            std::uint64_t data[3]; // value, time_enabled, time_running
+            if (fds[c] >= 0 && read(fds[c], data, sizeof(data)) == static_cast<ssize_t>(sizeof(data)) && data[2] > 0)
+            {
+                v.valid[c] = true;
+                v.value[c] = static_cast<double>(data[0]) * data[1] / data[2] / calls;
+            }
+        }
+#else
+        (void)calls;
+#endif
+        return v;
+    }
+
+  private:
+#if defined(__linux__)
+    static int open(std::uint32_t type, std::uint64_t config, bool userOnly) noexcept
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = type;
+        attr.config = config;
+        attr.disabled = 1;
+        attr.exclude_kernel = userOnly; // required at perf_event_paranoid 2
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0)); // this thread, any CPU
+    }
+
+    int fds[counterCount] = {-1, -1, -1, -1, -1, -1};
+#endif
+    bool anyOpen = false;
+    std::string reason;
+};
+} // namespace timing
+
+#endif // !__PERF_COUNTERS_H__
@@ -1,3 +1,4 @@
+#include "timing.h"
 #include <boost/type_index.hpp>
 #include <chrono>
 #include <cstdio>
@@ -87,9 +88,37 @@ void test_timer_func()
     timeFuncInvocations(test_func, 1, 2);
 }
 
-int main()
+// the same measurement with timing.h: warm-up, calibrated repetitions, and
+// statistics instead of a single reading
+void test_timing_harness(timing::Report &report)
 {
-    test_universal_ref();
-    test_timer_func();
+    auto test_func = [](int a, int b) {
+        int acc = a;
+        for (int i = 0; i < 1024; ++i)
+        {
+            acc = acc * 31 + b;
+            timing::doNotOptimize(acc); // otherwise the whole loop may be folded away
+        }
+    };
+
+    report.run("test_func(1, 2)", test_func, 1, 2);
+
+    std::vector<int> v(1024, 1);
+    report.run("copy vector<int>(1024)", [](const std::vector<int> &src) {
+        std::vector<int> copy(src);
+        timing::doNotOptimize(copy.data());
+    }, v);
+}
+
+int main(int argc, char *argv[])
+{
+    timing::Report report(argc, argv); // --format=json|csv, --out=<file>
+    if (report.log() == stdout) // the demos print to stdout, which a JSON or CSV report needs for itself
+    {
+        test_universal_ref();
+        test_timer_func();
+    }
+    test_timing_harness(report);
+    report.print();
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,458 @@
+#ifndef __TIMING_H__
+#define __TIMING_H__
+
+#include "perf_counters.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+// timeFuncInvocations from rref_and_universal_ref.cpp, grown into a small
+// microbenchmark harness.
+// • Same call shape: a callable followed by its arguments, taken by universal
+// reference.
+// • The callable runs for a warm-up period, then the harness calibrates how
+// many calls fill one sample, takes repeated samples and reports the median,
+// p99 and median absolute deviation (MAD) of the per-call time.
+// • doNotOptimize/clobberMemory keep the optimizer from deleting the work.
+// • Results print as a console table, JSON or CSV, to stdout, to the file of
+// --out=<file> or to a FILE* the program passes in. A program prints its own
+// lines to Report::log(), which is stderr while a JSON or CSV report has
+// stdout, so the report can be piped to a parser.
+// • With Options::counters (or --counters) the samples also run under the
+// hardware counters of perf_counters.h, reported per call.
+//
+// The repeated calls of a benchmark can't consume an rvalue more than once, so
+// they pass the arguments as lvalues.
+
+namespace timing
+{
+// forces value to be materialized, as if something read it
+template <typename T> inline void doNotOptimize(T const &value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void *sink;
+    sink = &value;
+#endif
+}
+
+// forces pending writes to memory, as if something might read any of it
+inline void clobberMemory()
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : : "memory");
+#else
+    std::atomic_signal_fence(std::memory_order_seq_cst);
+#endif
+}
+
+using Clock = std::chrono::steady_clock;
+
+struct Options
+{
+    std::chrono::nanoseconds warmup = std::chrono::milliseconds(20);
+    std::chrono::nanoseconds sampleTime = std::chrono::milliseconds(2); // calibration target per sample
+    std::size_t samples = 31;
+    bool counters = false; // collect perf_event counters while sampling, where available
+};
+
+struct Stats
+{
+    std::string name;
+    std::size_t iterations = 0; // calls per sample
+    std::size_t samples = 0;
+    double medianNs = 0; // per call, as are all the times
+    double p99Ns = 0;
+    double madNs = 0;
+    double minNs = 0;
+    double meanNs = 0;
+    CounterValues counters; // per call; only the valid ones were measured
+};
+
+namespace detail
+{
+inline double median(std::vector<double> sorted)
+{
+    std::size_t n = sorted.size();
+    return n % 2 ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2;
+}
+
+inline Stats summarize(std::string name, std::size_t iterations, std::vector<double> perCallNs)
+{
+    std::sort(perCallNs.begin(), perCallNs.end());
+    Stats s;
+    s.name = std::move(name);
+    s.iterations = iterations;
+    s.samples = perCallNs.size();
+    s.medianNs = median(perCallNs);
+    std::size_t p99Rank = static_cast<std::size_t>(std::ceil(0.99 * perCallNs.size())); // nearest rank
+    s.p99Ns = perCallNs[std::min(perCallNs.size(), p99Rank) - 1];
+    s.minNs = perCallNs.front();
+    double sum = 0;
+    for (double x : perCallNs)
+    {
+        sum += x;
+    }
+    s.meanNs = sum / perCallNs.size();
+
+    std::vector<double> deviations;
+    deviations.reserve(perCallNs.size());
+    for (double x : perCallNs)
+    {
+        deviations.push_back(std::fabs(x - s.medianNs));
+    }
+    std::sort(deviations.begin(), deviations.end());
+    s.madNs = median(deviations);
+    return s;
+}
+
+// name as the inside of a JSON string
+inline std::string jsonEscape(const std::string &name)
+{
+    std::string escaped;
+    for (char c : name)
+    {
+        if (c == '"' || c == '\\')
+        {
+            escaped += '\\';
+            escaped += c;
+        }
+        else if (static_cast<unsigned char>(c) < 0x20)
+        {
+            char code[8];
+            std::snprintf(code, sizeof(code), "\\u%04x", static_cast<unsigned>(c));
+            escaped += code;
+        }
+        else
+        {
+            escaped += c;
+        }
+    }
+    return escaped;
+}
+
+// name as a quoted CSV field: commas and line breaks stay inside the quotes,
+// quotes are doubled
+inline std::string csvQuote(const std::string &name)
+{
+    std::string quoted = "\"";
+    for (char c : name)
+    {
+        quoted += c;
+        if (c == '"')
+        {
+            quoted += '"';
+        }
+    }
+    return quoted + '"';
+}
+
+template <typename Func, typename... Args> double timeBatch(std::size_t iterations, Func &func, Args &...args)
+{
+    auto start = Clock::now();
+    for (std::size_t i = 0; i < iterations; ++i)
+    {
+        func(args...);
+        clobberMemory();
+    }
+    auto end = Clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+} // namespace detail
+
+// warm up, calibrate, sample; returns per-call statistics
+template <typename Func, typename... Args>
+Stats timeFuncInvocations(const Options &opt, std::string name, Func &&func, Args &&...args)
+{
+    const double warmupNs = std::chrono::duration<double, std::nano>(opt.warmup).count();
+    const double sampleNs = std::chrono::duration<double, std::nano>(opt.sampleTime).count();
+
+    for (double spent = 0; spent < warmupNs;)
+    {
+        spent += detail::timeBatch(1, func, args...);
+    }
+
+    // double the batch until it takes at least sampleTime
+    std::size_t iterations = 1;
+    while (detail::timeBatch(iterations, func, args...) < sampleNs && iterations < (std::size_t(1) << 40))
+    {
+        iterations *= 2;
+    }
+
+    std::vector<double> perCallNs;
+    const std::size_t samples = std::max<std::size_t>(opt.samples, 1);
+    perCallNs.reserve(samples);
+    CounterValues counters;
+    if (opt.counters)
+    {
+        PerfCounters perf;
+        if (!perf.available())
+        {
+            static bool warned = false; // once per program
+            if (!warned)
+            {
+                std::fprintf(stderr, "no hardware counters: %s\n", perf.why().c_str());
+                warned = true;
+            }
+        }
+        perf.start();
+        for (std::size_t s = 0; s < samples; ++s)
+        {
+            perCallNs.push_back(detail::timeBatch(iterations, func, args...) / iterations);
+        }
+        counters = perf.stop(static_cast<double>(iterations) * samples);
+    }
+    else
+    {
+        for (std::size_t s = 0; s < samples; ++s)
+        {
+            perCallNs.push_back(detail::timeBatch(iterations, func, args...) / iterations);
+        }
+    }
+    Stats stats = detail::summarize(std::move(name), iterations, std::move(perCallNs));
+    stats.counters = counters;
+    return stats;
+}
+
+template <typename Func, typename... Args> Stats timeFuncInvocations(std::string name, Func &&func, Args &&...args)
+{
+    return timeFuncInvocations(Options{}, std::move(name), std::forward<Func>(func), std::forward<Args>(args)...);
+}
+
+enum class Format
+{
+    console,
+    json,
+    csv
+};
+
+// collects the results of one program and prints them at the end
+class Report
+{
+  public:
+    explicit Report(Options opt = {}) : opt(opt)
+    {
+    }
+
+    // prints to out, which stays the caller's to close
+    Report(std::FILE *out, Format format, Options opt = {}) : opt(opt), format(format), out(out)
+    {
+    }
+
+    // understands --format=console|json|csv, --out=<file> and --counters
+    Report(int argc, char *argv[], Options opt = {}) : opt(opt)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            if (std::strcmp(argv[i], "--format=json") == 0)
+            {
+                format = Format::json;
+            }
+            else if (std::strcmp(argv[i], "--format=csv") == 0)
+            {
+                format = Format::csv;
+            }
+            else if (std::strncmp(argv[i], "--out=", 6) == 0)
+            {
+                openOut(argv[i] + 6);
+            }
+            else if (std::strcmp(argv[i], "--counters") == 0)
+            {
+                this->opt.counters = true;
+            }
+        }
+    }
+
+    ~Report()
+    {
+        if (!printed && !results.empty())
+        {
+            print();
+        }
+        if (ownsOut)
+        {
+            std::fclose(out);
+        }
+    }
+
+    Report(const Report &) = delete;
+    Report &operator=(const Report &) = delete;
+
+    template <typename Func, typename... Args> const Stats &run(std::string name, Func &&func, Args &&...args)
+    {
+        results.push_back(
+            timeFuncInvocations(opt, std::move(name), std::forward<Func>(func), std::forward<Args>(args)...));
+        return results.back();
+    }
+
+    const std::vector<Stats> &stats() const noexcept
+    {
+        return results;
+    }
+
+    // where the program's own output goes: stderr while a JSON or CSV report
+    // is printed to stdout, stdout otherwise
+    std::FILE *log() const noexcept
+    {
+        return format != Format::console && out == stdout ? stderr : stdout;
+    }
+
+    void print()
+    {
+        printed = true;
+        switch (format)
+        {
+        case Format::console:
+            printConsole(out);
+            break;
+        case Format::json:
+            printJson(out);
+            break;
+        case Format::csv:
+            printCsv(out);
+            break;
+        }
+        std::fflush(out);
+    }
+
+    void printConsole(FILE *out) const
+    {
+        std::fprintf(out, "%-48s %12s %12s %12s %12s %8s\n", "Benchmark", "median ns", "p99 ns", "MAD ns", "min ns",
+                     "samples");
+        for (const Stats &s : results)
+        {
+            std::fprintf(out, "%-48s %12.2f %12.2f %12.2f %12.2f %8zu\n", s.name.c_str(), s.medianNs, s.p99Ns, s.madNs,
+                         s.minNs, s.samples);
+        }
+        if (!anyCounters())
+        {
+            return;
+        }
+        std::fprintf(out, "\n%-48s", "Counters per call");
+        for (std::size_t c = 0; c < counterCount; ++c)
+        {
+            std::fprintf(out, " %16s", counterName(static_cast<Counter>(c)));
+        }
+        std::fprintf(out, "\n");
+        for (const Stats &s : results)
+        {
+            std::fprintf(out, "%-48s", s.name.c_str());
+            for (std::size_t c = 0; c < counterCount; ++c)
+            {
+                if (s.counters.valid[c])
+                {
+                    std::fprintf(out, " %16.2f", s.counters.value[c]);
+                }
+                else
+                {
+                    std::fprintf(out, " %16s", "-");
+                }
+            }
+            std::fprintf(out, "\n");
+        }
+    }
+
+    void printJson(FILE *out) const
+    {
+        std::fprintf(out, "{\n  \"benchmarks\": [\n");
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            const Stats &s = results[i];
+            std::fprintf(out,
+                         "    {\"name\": \"%s\", \"iterations\": %zu, \"samples\": %zu, \"median_ns\": %.4f, "
+                         "\"p99_ns\": %.4f, \"mad_ns\": %.4f, \"min_ns\": %.4f, \"mean_ns\": %.4f",
+                         detail::jsonEscape(s.name).c_str(), s.iterations, s.samples, s.medianNs, s.p99Ns, s.madNs,
+                         s.minNs, s.meanNs);
+            bool first = true;
+            for (std::size_t c = 0; c < counterCount; ++c)
+            {
+                if (s.counters.valid[c])
+                {
+                    std::fprintf(out, "%s\"%s\": %.4f", first ? ", \"counters\": {" : ", ",
+                                 counterName(static_cast<Counter>(c)), s.counters.value[c]);
+                    first = false;
+                }
+            }
+            std::fprintf(out, "%s}%s\n", first ? "" : "}", i + 1 < results.size() ? "," : "");
+        }
+        std::fprintf(out, "  ]\n}\n");
+    }
+
+    void printCsv(FILE *out) const
+    {
+        std::fprintf(out, "name,iterations,samples,median_ns,p99_ns,mad_ns,min_ns,mean_ns");
+        for (std::size_t c = 0; c < counterCount; ++c)
+        {
+            std::fprintf(out, ",%s", counterName(static_cast<Counter>(c)));
+        }
+        std::fprintf(out, "\n");
+        for (const Stats &s : results)
+        {
+            std::fprintf(out, "%s,%zu,%zu,%.4f,%.4f,%.4f,%.4f,%.4f", detail::csvQuote(s.name).c_str(), s.iterations,
+                         s.samples, s.medianNs, s.p99Ns, s.madNs, s.minNs, s.meanNs);
+            for (std::size_t c = 0; c < counterCount; ++c)
+            {
+                if (s.counters.valid[c])
+                {
+                    std::fprintf(out, ",%.4f", s.counters.value[c]);
+                }
+                else
+                {
+                    std::fprintf(out, ","); // not measured
+                }
+            }
+            std::fprintf(out, "\n");
+        }
+    }
+
+  private:
+    void openOut(const char *path)
+    {
+        if (std::FILE *file = std::fopen(path, "w"))
+        {
+            if (ownsOut)
+            {
+                std::fclose(out);
+            }
+            out = file;
+            ownsOut = true;
+        }
+        else
+        {
+            std::fprintf(stderr, "cannot open %s, the report goes to stdout\n", path);
+        }
+    }
+
+    bool anyCounters() const noexcept
+    {
+        for (const Stats &s : results)
+        {
+            for (bool valid : s.counters.valid)
+            {
+                if (valid)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    Options opt;
+    Format format = Format::console;
+    std::FILE *out = stdout;
+    bool ownsOut = false; // opened for --out
+    std::vector<Stats> results;
+    bool printed = false;
+};
+} // namespace timing
+
+#endif // !__TIMING_H__
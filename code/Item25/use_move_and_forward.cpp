@@ -1,3 +1,4 @@
+#include "../Item23/instrumented.h"
 #include <boost/type_index.hpp>
 #include <cstdio>
 #include <memory>
@@ -11,7 +12,7 @@
 // • Never apply std::move or std::forward to local objects if they would other‐
 // wise be eligible for the return value optimization.
 
-class Widget
+class Widget : public instrumented::Counted<Widget> // counts constructions and moves
 {
   public:
     Widget() : name("default"), p(std::make_shared<SomeDataStructure>())
@@ -20,7 +21,7 @@ class Widget
     }
 
     Widget(Widget &&rhs) // rhs is an rvalue reference
-        : name(std::move(rhs.name)), p(std::move(rhs.p))
+        : Counted(std::move(rhs)), name(std::move(rhs.name)), p(std::move(rhs.p))
     {
         printf("Widget move constructor\n");
     }
@@ -240,12 +241,12 @@ T no_use_move_as_return_value(T &&t)
     return t;
 }
 
-struct Processable
+struct Processable : instrumented::Counted<Processable>
 {
     Processable() {printf("Processable default constructor\n");}
     ~Processable() {printf("Processable destructor\n");}
-    Processable(const Processable &) {printf("Processable copy constructor\n");}
-    Processable(Processable &&) {printf("Processable move constructor\n");}
+    Processable(const Processable &rhs) : Counted(rhs) {printf("Processable copy constructor\n");}
+    Processable(Processable &&rhs) : Counted(std::move(rhs)) {printf("Processable move constructor\n");}
     Processable &operator=(const Processable &) {printf("Processable copy assignment\n"); return *this;}
     Processable &operator=(Processable &&) {printf("Processable move assignment\n"); return *this;}
     void process() {printf("processing\n");}
@@ -253,23 +254,44 @@ struct Processable
 
 void test_makeWidget()
 {
+    instrumented::reset<Widget>();
     printf("calling makeWidget\n");
-    Widget w = makeWidget();
+    {
+        Widget w = makeWidget();
+    }
+    instrumented::Counts rvo = instrumented::counts<Widget>();
 
     printf("calling makeWidgetNoRVO\n");
-    Widget w2 = makeWidgetNoRVO();
+    {
+        Widget w2 = makeWidgetNoRVO();
+    }
+    instrumented::Counts noRvo = instrumented::counts<Widget>() - rvo;
+
+    instrumented::printHeader();
+    instrumented::print("makeWidget", rvo);        // no move at all
+    instrumented::print("makeWidgetNoRVO", noRvo);    // one move, one more destruction
 }
 
 void test_use_move_as_return_value()
 {
+    instrumented::reset<Processable>();
     printf("calling use_move_as_return_value\n");
-    auto ret = use_move_as_return_value(Processable{});
+    {
+        auto ret = use_move_as_return_value(Processable{});
+    }
+    instrumented::printHeader();
+    instrumented::print("use_move_as_return_value", instrumented::counts<Processable>()); // moved out
 }
 
 void test_no_use_move_as_return_value()
 {
+    instrumented::reset<Processable>();
     printf("calling no_use_move_as_return_value\n");
-    auto ret = no_use_move_as_return_value(Processable{});
+    {
+        auto ret = no_use_move_as_return_value(Processable{});
+    }
+    instrumented::printHeader();
+    instrumented::print("no_use_move_as_return_value", instrumented::counts<Processable>()); // copied out
 }
 
 int main()
@@ -1,3 +1,4 @@
+#include "../Item23/instrumented.h"
 #include <boost/type_index.hpp>
 #include <cstdio>
 #include <string>
@@ -10,20 +11,34 @@
 // typically better matches than copy constructors for non-const lvalues, and
 // they can hijack derived class calls to base class copy and move constructors.
 
-std::multiset<std::string> names; 
-void logAndAdd(const std::string & name)
+// a std::string that counts its copies and moves, see instrumented.h
+using Name = instrumented::Instrumented<std::string>;
+
+std::multiset<Name> names;
+void logAndAdd(const Name & name)
 {
     auto now = std::chrono::system_clock::now();
     // log(now, "logAndAdd");
     names.emplace(name);
 }
 
+void printNameCounts(const char *version)
+{
+    instrumented::Counts c = instrumented::counts<std::string>();
+    printf("%s: %llu constructions, %llu copies, %llu moves\n", version,
+           static_cast<unsigned long long>(c[instrumented::constructions]),
+           static_cast<unsigned long long>(c[instrumented::copies]),
+           static_cast<unsigned long long>(c[instrumented::moves]));
+}
+
 void test_first_version()
 {
-    std::string petName("Darla");
+    Name petName("Darla");
+    instrumented::reset<std::string>();
     logAndAdd(petName); // passing lvalue
-    logAndAdd(std::string("Persephone")); // passing rvalue
+    logAndAdd(Name("Persephone")); // passing rvalue
     logAndAdd("Patty Dog"); // passing literal
+    printNameCounts("const Name &"); // 3 copies: the rvalue and the literal's temporary are copied too
 }
 
 // second version, using template and universal reference
@@ -37,10 +52,12 @@ void logAndAdd(T&& name)
 
 void test_second_version()
 {
-    std::string petName = "Darla";
+    Name petName = "Darla";
+    instrumented::reset<std::string>();
     logAndAdd(petName); // passing lvalue, same as above
-    logAndAdd(std::string("Persephone")); // passing rvalue, forwading rvalue to emplace
+    logAndAdd(Name("Persephone")); // passing rvalue, forwading rvalue to emplace
     logAndAdd("Patty Dog"); // passing literal, forwarding literal to emplace
+    printNameCounts("T&&"); // 1 copy, 1 move, and the literal builds the element in place
 }
 
 // problem: we need a logAndAdd(int idx) function.
@@ -0,0 +1,197 @@
+#include "../Item23/instrumented.h"
+#include "../Item24/counting_new.h"
+#include "../Item24/timing.h"
+#include <array>
+#include <cstddef>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Measures the hidden copy of iterator_of_map() in use_auto_if_you_can.cpp.
+//
+// The elements of a std::map<K, V> are std::pair<const K, V>, so a loop
+// variable declared as const std::pair<K, V> & binds to a converted temporary:
+// one key copy, one value copy and, for a std::string that doesn't fit the
+// small string buffer, one allocation per element. The other loop forms bind
+// to the element itself.
+// • The table of copies uses counted keys and values (see
+// Item23/instrumented.h), and the global operator new of Item24/counting_new.h
+// counts allocations.
+// • The timed loops run over plain std::map<int, std::string>, so the times
+// don't include the counters. They still allocate through the counting
+// operator new, which adds three relaxed atomic adds to each malloc.
+// • A flat map, a sorted std::vector<std::pair<K, V>>, is there for
+// comparison: its elements really are std::pair<K, V>, so the explicit type
+// is right and nothing is copied.
+// • Timings go through the harness of Item24/timing.h, which also understands
+// --format=json|csv and --out=<file>.
+
+// the counted types, for the table of copies
+using CountedKey = instrumented::Instrumented<int>;
+using CountedValue = instrumented::Instrumented<std::string>;
+
+template <typename K, typename V> using Map = std::map<K, V>;
+template <typename K, typename V> using FlatMap = std::vector<std::pair<K, V>>; // sorted by key
+
+// long enough not to fit in the small string buffer
+std::string valueFor(int key)
+{
+    return std::string("value number ") + std::to_string(key) + " of the benchmark";
+}
+
+template <typename K, typename V> Map<K, V> makeMap(int size)
+{
+    Map<K, V> m;
+    for (int k = 0; k < size; ++k)
+    {
+        m.emplace(k, valueFor(k));
+    }
+    return m;
+}
+
+template <typename K, typename V> FlatMap<K, V> makeFlatMap(int size)
+{
+    FlatMap<K, V> m;
+    m.reserve(size);
+    for (int k = 0; k < size; ++k) // already in order
+    {
+        m.emplace_back(k, valueFor(k));
+    }
+    return m;
+}
+
+// the same loop bodies for the counted and the plain types
+int keyOf(int key)
+{
+    return key;
+}
+int keyOf(const CountedKey &key)
+{
+    return key.get();
+}
+std::size_t sizeOf(const std::string &value)
+{
+    return value.size();
+}
+std::size_t sizeOf(const CountedValue &value)
+{
+    return value->size();
+}
+
+template <typename K, typename V, typename M> std::size_t explicitPair(const M &m)
+{
+    std::size_t sum = 0;
+    for (const std::pair<K, V> &p : m) // a copy for std::map, the element for FlatMap
+    {
+        sum += keyOf(p.first) + sizeOf(p.second);
+    }
+    return sum;
+}
+
+template <typename M> std::size_t autoRef(const M &m)
+{
+    std::size_t sum = 0;
+    for (const auto &p : m)
+    {
+        sum += keyOf(p.first) + sizeOf(p.second);
+    }
+    return sum;
+}
+
+template <typename M> std::size_t iterator(const M &m)
+{
+    std::size_t sum = 0;
+    for (auto it = m.begin(); it != m.end(); ++it)
+    {
+        sum += keyOf(it->first) + sizeOf(it->second);
+    }
+    return sum;
+}
+
+template <typename M> std::size_t structuredBindings(const M &m)
+{
+    std::size_t sum = 0;
+    for (const auto &[key, value] : m)
+    {
+        sum += keyOf(key) + sizeOf(value);
+    }
+    return sum;
+}
+
+template <typename K, typename V> struct LoopForm
+{
+    const char *name;
+    std::size_t (*overMap)(const Map<K, V> &);
+    std::size_t (*overFlatMap)(const FlatMap<K, V> &);
+};
+
+template <typename K, typename V> std::array<LoopForm<K, V>, 4> loopForms()
+{
+    using M = Map<K, V>;
+    using F = FlatMap<K, V>;
+    return {{
+        {"const std::pair<K, V> &", explicitPair<K, V, M>, explicitPair<K, V, F>},
+        {"const auto &", autoRef<M>, autoRef<F>},
+        {"iterator", iterator<M>, iterator<F>},
+        {"const auto &[k, v]", structuredBindings<M>, structuredBindings<F>},
+    }};
+}
+
+// runs one loop once and prints its copies and allocations per element
+template <typename M>
+void countOne(std::FILE *out, const char *container, const char *form, std::size_t (*loop)(const M &), const M &m)
+{
+    instrumented::reset<int>();
+    instrumented::reset<std::string>();
+    std::size_t allocsBefore = counting_new::allocations;
+    timing::doNotOptimize(loop(m));
+    std::size_t allocs = counting_new::allocations - allocsBefore;
+    double n = static_cast<double>(m.size());
+    std::fprintf(out, "%-8s %-26s %8zu %12.2f %12.2f %12.2f\n", container, form, m.size(),
+                 instrumented::counts<int>()[instrumented::copies] / n,
+                 instrumented::counts<std::string>()[instrumented::copies] / n, allocs / n);
+}
+
+int main(int argc, char *argv[])
+{
+    const int sizes[] = {16, 1024, 65536};
+
+    timing::Options opt;
+    opt.warmup = std::chrono::milliseconds(5);
+    opt.sampleTime = std::chrono::milliseconds(1);
+    opt.samples = 11;
+    timing::Report report(argc, argv, opt);
+
+    std::fprintf(report.log(), "%-8s %-26s %8s %12s %12s %12s\n", "map", "loop", "size", "key copies", "value copies",
+                 "allocations");
+    for (int size : sizes)
+    {
+        auto m = makeMap<CountedKey, CountedValue>(size);
+        auto flat = makeFlatMap<CountedKey, CountedValue>(size);
+        for (const auto &form : loopForms<CountedKey, CountedValue>())
+        {
+            countOne(report.log(), "map", form.name, form.overMap, m);
+        }
+        for (const auto &form : loopForms<CountedKey, CountedValue>())
+        {
+            countOne(report.log(), "flat", form.name, form.overFlatMap, flat);
+        }
+    }
+    std::fprintf(report.log(), "(per element)\n\n");
+
+    for (int size : sizes)
+    {
+        auto m = makeMap<int, std::string>(size);
+        auto flat = makeFlatMap<int, std::string>(size);
+        for (const auto &form : loopForms<int, std::string>())
+        {
+            std::string suffix = std::string(" ") + form.name + " " + std::to_string(size);
+            report.run("map" + suffix, [&] { timing::doNotOptimize(form.overMap(m)); });
+            report.run("flat" + suffix, [&] { timing::doNotOptimize(form.overFlatMap(flat)); });
+        }
+    }
+    report.print();
+    return 0;
+}
@@ -1,3 +1,4 @@
+#include "../Item23/instrumented.h"
 #include <cstdio>
 #include <functional>
 #include <iterator>
@@ -62,28 +63,35 @@ void warnings_of_use_container()
 // auto can be used to avoid the problem of temporary object in the loop of map
 void iterator_of_map()
 {
-    std::map<int, std::string> m;
+    using Value = instrumented::Instrumented<std::string>; // counts its copies, see Item23/instrumented.h
+    std::map<int, Value> m;
     m[1] = "one";
     m[2] = "two";
     m[3] = "three";
 
-    for (const std::pair<int, std::string> &p : m) // the key of the map is const, so the std::pair's type is not
+    instrumented::reset<std::string>();
+    for (const std::pair<int, Value> &p : m) // the key of the map is const, so the std::pair's type is not
                                                    // std::pair<int, std::string>, but std::pair<const int, std::string>. The conversion
                                                     // is done by the compiler with an implicit conversion, which will copy every element
                                                     // in the map to a new std::pair<int, std::string> object (temporary object), and then 
                                                     // bind the reference to the temporary object. This is inefficient.
                                                     // at the end of the loop, the temporary object will be destroyed, which is also inefficient.
-                                                    // you can change `int` to your own type and see how many times the copy constructor is called.
+                                                    // Value counts how many times the copy constructor is called.
     {
-        printf("key: %d, value: %s\n", p.first, p.second.c_str());
+        printf("key: %d, value: %s\n", p.first, p.second->c_str());
     }
+    printf("copies: %llu\n",
+           static_cast<unsigned long long>(instrumented::counts<std::string>()[instrumented::copies]));
 
 
     // we can use auto to avoid the problem
+    instrumented::reset<std::string>();
     for (auto it = m.begin(); it != m.end(); ++it)
     {
-        printf("key: %d, value: %s\n", it->first, it->second.c_str());
+        printf("key: %d, value: %s\n", it->first, it->second->c_str());
     }
+    printf("copies: %llu\n",
+           static_cast<unsigned long long>(instrumented::counts<std::string>()[instrumented::copies]));
 }
 
 // in the end, `auto` is optional, but it can make the code more readable and maintainable,